@@ -0,0 +1,235 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+#include "Sandbox.h"
+#include "Scenario.h"
+
+#define DEFAULT_FRAMES 500
+#define DEFAULT_SEED 1
+
+typedef struct BenchmarkResult {
+
+	std::string name;
+
+	double nsPerFrame;
+	double cellsPerSecond;
+	long long swaps;
+	double p50FrameNs;
+	double p99FrameNs;
+	long long peakRssBytes;
+	double uploadBytesPerFrame;
+
+}BenchmarkResult;
+
+//Peak resident set of the whole process so far, scenarios run one after another so it never goes down
+static long long PeakRssBytes() {
+
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return (long long)counters.PeakWorkingSetSize;
+
+    return 0;
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+#ifdef __APPLE__
+    return (long long)usage.ru_maxrss;
+#else
+    return (long long)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+static double Percentile(std::vector<double>& sorted, double p) {
+
+    size_t index = (size_t)(p * (sorted.size() - 1) + 0.5);
+
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+static BenchmarkResult RunBenchmark(const Scenario& scenario, int width, int height, int frames, double dt, int threads, unsigned long long seed) {
+
+    //Same numbers for every scenario and every commit
+    SeedRandom(seed, RANDOM_COUNTER);
+
+    Sandbox sandbox(width, height);
+    sandbox.UpdateDeltaTime(dt);
+    sandbox.SetThreadCount(threads);
+
+    scenario.setup(sandbox);
+    sandbox.ClearLookChanges();
+
+    std::vector<double> frameNs;
+    frameNs.reserve(frames);
+
+    long long updatedCells = 0;
+    long long swaps = 0;
+    long long uploadBytes = 0;
+
+    for (int frame = 0; frame < frames; frame++) {
+
+        if (scenario.step)
+            scenario.step(sandbox, frame);
+
+        auto start = std::chrono::steady_clock::now();
+
+        sandbox.Update();
+
+        auto end = std::chrono::steady_clock::now();
+
+        frameNs.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+        updatedCells += sandbox.lastUpdatedCells;
+        swaps += sandbox.lastSwapCount;
+
+        //About what Renderer::UploadLooks sends, the whole buffer once half of the cells changed
+        long long changed = (long long)sandbox.changedCells.size();
+        long long numCells = (long long)width * height;
+        long long rows = std::max(sandbox.changedRowMax - sandbox.changedRowMin + 1, 0);
+        uploadBytes += std::min(changed >= numCells / 2 ? numCells : changed + rows * width, numCells) * sizeof(*sandbox.looks);
+
+        sandbox.ClearLookChanges();
+    }
+
+    double totalNs = 0.0;
+    for (double ns : frameNs)
+        totalNs += ns;
+
+    std::sort(frameNs.begin(), frameNs.end());
+
+    BenchmarkResult result;
+
+    result.name = scenario.name;
+    result.nsPerFrame = totalNs / frames;
+    result.cellsPerSecond = totalNs > 0.0 ? updatedCells / (totalNs / 1e9) : 0.0;
+    result.swaps = swaps;
+    result.p50FrameNs = Percentile(frameNs, 0.50);
+    result.p99FrameNs = Percentile(frameNs, 0.99);
+    result.peakRssBytes = PeakRssBytes();
+    result.uploadBytesPerFrame = (double)uploadBytes / frames;
+
+    return result;
+}
+
+static void PrintUsage() {
+
+    std::cout << "Usage: Benchmark [options]" << std::endl;
+    std::cout << "  --scenario <name>   run only this scenario, may be repeated (default: all)" << std::endl;
+    std::cout << "  --frames <n>        frames per scenario (default: " << DEFAULT_FRAMES << ")" << std::endl;
+    std::cout << "  --width <cells>     grid width in cells (default: " << SCREEN_WIDTH / TILE_SIZE << ")" << std::endl;
+    std::cout << "  --height <cells>    grid height in cells (default: " << SCREEN_HEIGHT / TILE_SIZE << ")" << std::endl;
+    std::cout << "  --threads <n>       thread count passed to Sandbox::SetThreadCount (default: 0)" << std::endl;
+    std::cout << "  --seed <n>          seed of the counter-based random numbers (default: " << DEFAULT_SEED << ")" << std::endl;
+    std::cout << "Prints one JSON object with the results of every scenario." << std::endl;
+}
+
+int main(int argc, char** argv) {
+
+    std::vector<std::string> names;
+    int frames = DEFAULT_FRAMES;
+    int width = SCREEN_WIDTH / TILE_SIZE;
+    int height = SCREEN_HEIGHT / TILE_SIZE;
+    int threads = 0;
+    unsigned long long seed = DEFAULT_SEED;
+    double dt = 1.0 / 100.0;
+
+    for (int i = 1; i < argc; i++) {
+
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--scenario" && hasValue) {
+            names.push_back(argv[++i]);
+        }
+        else if (arg == "--frames" && hasValue) {
+            frames = atoi(argv[++i]);
+        }
+        else if (arg == "--width" && hasValue) {
+            width = atoi(argv[++i]);
+        }
+        else if (arg == "--height" && hasValue) {
+            height = atoi(argv[++i]);
+        }
+        else if (arg == "--threads" && hasValue) {
+            threads = atoi(argv[++i]);
+        }
+        else if (arg == "--seed" && hasValue) {
+            seed = strtoull(argv[++i], NULL, 10);
+        }
+        else {
+
+            PrintUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    if (frames <= 0 || width <= 0 || height <= 0) {
+
+        std::cerr << "Frames, width and height must be positive" << std::endl;
+        return 1;
+    }
+
+    std::vector<const Scenario*> scenarios;
+
+    if (names.empty()) {
+
+        for (const Scenario& scenario : GetScenarios())
+            scenarios.push_back(&scenario);
+    }
+
+    for (const std::string& name : names) {
+
+        const Scenario* scenario = FindScenario(name);
+
+        if (scenario == NULL) {
+
+            std::cerr << "Unknown scenario: " << name << std::endl;
+            return 1;
+        }
+
+        scenarios.push_back(scenario);
+    }
+
+    std::cout << "{" << std::endl;
+    std::cout << "  \"width\": " << width << "," << std::endl;
+    std::cout << "  \"height\": " << height << "," << std::endl;
+    std::cout << "  \"frames\": " << frames << "," << std::endl;
+    std::cout << "  \"threads\": " << threads << "," << std::endl;
+    std::cout << "  \"seed\": " << seed << "," << std::endl;
+    std::cout << "  \"scenarios\": [" << std::endl;
+
+    for (size_t i = 0; i < scenarios.size(); i++) {
+
+        BenchmarkResult result = RunBenchmark(*scenarios[i], width, height, frames, dt, threads, seed);
+
+        std::cout << "    {" << std::endl;
+        std::cout << "      \"name\": \"" << result.name << "\"," << std::endl;
+        std::cout << "      \"ns_per_frame\": " << (long long)result.nsPerFrame << "," << std::endl;
+        std::cout << "      \"cells_updated_per_sec\": " << (long long)result.cellsPerSecond << "," << std::endl;
+        std::cout << "      \"swaps\": " << result.swaps << "," << std::endl;
+        std::cout << "      \"p50_frame_ns\": " << (long long)result.p50FrameNs << "," << std::endl;
+        std::cout << "      \"p99_frame_ns\": " << (long long)result.p99FrameNs << "," << std::endl;
+        std::cout << "      \"peak_rss_bytes\": " << result.peakRssBytes << "," << std::endl;
+        std::cout << "      \"upload_bytes_per_frame\": " << (long long)result.uploadBytesPerFrame << std::endl;
+        std::cout << "    }" << (i + 1 < scenarios.size() ? "," : "") << std::endl;
+    }
+
+    std::cout << "  ]" << std::endl;
+    std::cout << "}" << std::endl;
+
+    return 0;
+}
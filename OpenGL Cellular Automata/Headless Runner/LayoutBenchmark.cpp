@@ -0,0 +1,159 @@
+#include "LayoutBenchmark.h"
+#include "CellGrid.h"
+
+#include <iostream>
+#include <chrono>
+#include <utility>
+
+#define LAYOUT_FILL_RATE 40
+
+//The old cell_t with a frame stamp next to it, CellGrid keeps the same stamp in an array of its own. Both sides track
+//moved cells the same way, so only the layout differs
+typedef struct StampedCell {
+
+    cell_t cell;
+    uint16_t stamp;
+
+}StampedCell;
+
+static void FillGrids(StampedCell* aos, CellGrid& soa, int width, int height) {
+
+    SeedRandom(1, RANDOM_FAST);
+
+    for (int i = 0; i < width * height; i++) {
+
+        cell_t cell = RandomU32() % 100 < LAYOUT_FILL_RATE ? cell_sand() : cell_empty();
+
+        aos[i] = { cell, 0 };
+        soa.Set(i, cell);
+    }
+}
+
+//Both sweeps move a cell down or diagonally down like the sand rule. Sand on the bottom row goes back to the top so the grid never settles
+static long long SweepAoS(StampedCell* cells, int width, int height, uint16_t& frameStamp) {
+
+    long long moves = 0;
+
+    for (int y = 1; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+
+            int i = width * y + x;
+
+            if (cells[i].cell.type != SAND || cells[i].stamp == frameStamp)
+                continue;
+
+            int below = i - width;
+
+            if (cells[below].cell.type != EMPTY) {
+
+                int dx = (x + y) % 2 ? 1 : -1;
+
+                if (x + dx < 0 || x + dx >= width || cells[below + dx].cell.type != EMPTY)
+                    continue;
+
+                below += dx;
+            }
+
+            std::swap(cells[i], cells[below]);
+            cells[below].stamp = frameStamp;
+            moves++;
+        }
+    }
+
+    //As CellGrid::AdvanceFrame
+    if (++frameStamp == 0) {
+
+        for (int i = 0; i < width * height; i++)
+            cells[i].stamp = 0;
+
+        frameStamp = 1;
+    }
+
+    for (int x = 0; x < width; x++) {
+
+        if (cells[x].cell.type == SAND)
+            std::swap(cells[x], cells[width * (height - 1) + x]);
+    }
+
+    return moves;
+}
+
+static long long SweepSoA(CellGrid& cells, int width, int height) {
+
+    long long moves = 0;
+
+    for (int y = 1; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+
+            int i = width * y + x;
+
+            if (cells.Type(i) != SAND || cells.HasMoved(i))
+                continue;
+
+            int below = i - width;
+
+            if (cells.Type(below) != EMPTY) {
+
+                int dx = (x + y) % 2 ? 1 : -1;
+
+                if (x + dx < 0 || x + dx >= width || cells.Type(below + dx) != EMPTY)
+                    continue;
+
+                below += dx;
+            }
+
+            cells.Swap(i, below);
+            cells.SetMoved(below, true);
+            moves++;
+        }
+    }
+
+    cells.AdvanceFrame();
+
+    for (int x = 0; x < width; x++) {
+
+        if (cells.Type(x) == SAND)
+            cells.Swap(x, width * (height - 1) + x);
+    }
+
+    return moves;
+}
+
+static void RunSize(int width, int height, int passes) {
+
+    StampedCell* aos = new StampedCell[width * height];
+    uint16_t aosStamp = 1;
+    CellGrid soa;
+    soa.Create(width * height);
+
+    FillGrids(aos, soa, width, height);
+
+    auto start = std::chrono::steady_clock::now();
+
+    long long aosMoves = 0;
+    for (int pass = 0; pass < passes; pass++)
+        aosMoves += SweepAoS(aos, width, height, aosStamp);
+
+    auto middle = std::chrono::steady_clock::now();
+
+    long long soaMoves = 0;
+    for (int pass = 0; pass < passes; pass++)
+        soaMoves += SweepSoA(soa, width, height);
+
+    auto end = std::chrono::steady_clock::now();
+
+    double aosSeconds = std::chrono::duration<double>(middle - start).count();
+    double soaSeconds = std::chrono::duration<double>(end - middle).count();
+    double cells = (double)width * height * passes;
+
+    std::cout << width << "x" << height << "\tAoS " << sizeof(StampedCell) << " B/cell\t" << cells / aosSeconds / 1e6 << " Mcells/s\t(" << aosMoves << " moves)" << std::endl;
+    std::cout << width << "x" << height << "\tSoA\t\t" << cells / soaSeconds / 1e6 << " Mcells/s\t(" << soaMoves << " moves)" << std::endl;
+
+    delete[] aos;
+}
+
+void RunLayoutBenchmark(int passes) {
+
+    RunSize(320, 180, passes);
+    RunSize(1280, 720, passes);
+}
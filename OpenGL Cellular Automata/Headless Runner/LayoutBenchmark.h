@@ -0,0 +1,5 @@
+#pragma once
+
+//Runs the same falling-sand sweep over an array of the old cell_t, each with a frame stamp, and over CellGrid and prints
+//cells per second for each
+void RunLayoutBenchmark(int passes);
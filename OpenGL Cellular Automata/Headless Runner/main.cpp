@@ -0,0 +1,351 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+
+#include "Sandbox.h"
+#include "Scenario.h"
+#include "ElementTraits.h"
+#include "LayoutBenchmark.h"
+
+#define DEFAULT_FRAMES 1000
+#define DEFAULT_DT (1.0 / 100.0)
+
+//FNV-1a over the cell looks, equal checksums mean the runs ended in the same state
+static unsigned long long LookChecksum(const Sandbox& sandbox) {
+
+    unsigned long long hash = 14695981039346656037ULL;
+
+    for (int y = 0; y < sandbox.height; y++) {
+
+        const unsigned char* bytes = (const unsigned char*)(sandbox.looks + sandbox.lookStride * y);
+
+        for (size_t i = 0; i < sandbox.width * sizeof(look_t); i++) {
+
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    return hash;
+}
+
+//Elements nothing turns into or out of, the update may only move them around
+static bool IsConserved(Element type) {
+
+    const ElementTraits& traits = GetTraits(type);
+
+    return type != EMPTY && type != BORDER && traits.phase != GAS && !traits.flammable;
+}
+
+//Runs the scenario on a fresh sandbox and checks after every frame that the update kept the count of every conserved
+//element, cells in flight included. Prints the first frame that did not and returns false
+static bool CheckMass(const Scenario& scenario, int width, int height, int frames, double dt, int threads, BoundaryMode boundary) {
+
+    SeedRandom(GetRandomSeed(), GetRandomMode());
+
+    Sandbox sandbox(width, height);
+    sandbox.UpdateDeltaTime(dt);
+    sandbox.SetThreadCount(threads);
+    sandbox.SetBoundary(boundary);
+
+    scenario.setup(sandbox);
+
+    for (int frame = 0; frame < frames; frame++) {
+
+        if (scenario.step)
+            scenario.step(sandbox, frame);
+
+        //The step may add cells, only the update is checked
+        ElementCensus before = sandbox.TakeCensus();
+
+        sandbox.Update();
+        sandbox.ClearLookChanges();
+
+        ElementCensus after = sandbox.TakeCensus();
+
+        for (int type = 0; type < NR_ELEMENTS; type++) {
+
+            if (!IsConserved((Element)type) || before.count[type] == after.count[type])
+                continue;
+
+            std::cout << scenario.name << ": element " << type << " went from " << before.count[type] << " to " << after.count[type] << " cells in frame " << frame << std::endl;
+            return false;
+        }
+    }
+
+    std::cout << scenario.name << ": ok" << std::endl;
+    return true;
+}
+
+//Stone with a shaft down to a pocket full of sand. Sand poured in at the top falls fast enough to fly, the shaft fills
+//up while it does and the last particles find no free cell anywhere near where they hit
+static const Scenario PocketScenario = { "pocket", "Sand poured down a shaft into a full pocket",
+    [](SimulationBackend& s) {
+        s.FillRect(0, 0, s.width - 1, s.height - 1, STONE);
+        s.ClearRect(s.width / 2 - 8, 4, s.width / 2 + 8, 24);
+        s.FillRect(s.width / 2 - 8, 4, s.width / 2 + 8, 24, SAND);
+        s.ClearRect(s.width / 2 - 2, 25, s.width / 2 + 2, s.height - 1);
+    },
+    [](SimulationBackend& s, int) {
+        Element previousType = s.currentType;
+        s.currentType = SAND;
+        s.FillRect(s.width / 2 - 2, s.height - 3, s.width / 2 + 2, s.height - 1, SAND);
+        s.currentType = previousType;
+    } };
+
+//Runs the scenario on a fresh sandbox and returns the wall time of the simulated frames in seconds
+static double RunScenario(const Scenario& scenario, int width, int height, int frames, double dt, int threads, BoundaryMode boundary, double* cellsPerFrame = NULL, unsigned long long* checksum = NULL) {
+
+    //Every run starts from the same seed so thread counts can be compared
+    SeedRandom(GetRandomSeed(), GetRandomMode());
+
+    Sandbox sandbox(width, height);
+    sandbox.UpdateDeltaTime(dt);
+    sandbox.SetThreadCount(threads);
+    sandbox.SetBoundary(boundary);
+
+    scenario.setup(sandbox);
+
+    long long updatedCells = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int frame = 0; frame < frames; frame++) {
+
+        if (scenario.step)
+            scenario.step(sandbox, frame);
+
+        sandbox.Update();
+        updatedCells += sandbox.lastUpdatedCells;
+
+        //Nothing uploads the looks here, drop them so the list does not grow forever
+        sandbox.ClearLookChanges();
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    if (cellsPerFrame != NULL)
+        *cellsPerFrame = (double)updatedCells / frames;
+
+    if (checksum != NULL)
+        *checksum = LookChecksum(sandbox);
+
+    return std::chrono::duration<double>(end - start).count();
+}
+
+static void PrintUsage() {
+
+    std::cout << "Usage: \"Headless Runner\" [options]" << std::endl;
+    std::cout << "  --scenario <name>   scenario to run (default: sand)" << std::endl;
+    std::cout << "  --frames <n>        number of frames to simulate (default: " << DEFAULT_FRAMES << ")" << std::endl;
+    std::cout << "  --width <cells>     grid width in cells (default: " << SCREEN_WIDTH / TILE_SIZE << ")" << std::endl;
+    std::cout << "  --height <cells>    grid height in cells (default: " << SCREEN_HEIGHT / TILE_SIZE << ")" << std::endl;
+    std::cout << "  --dt <seconds>      fixed time step (default: " << DEFAULT_DT << ")" << std::endl;
+    std::cout << "  --threads <n>       update the phases of chunk columns on n threads, 0 or 1 = on this thread (default: 0)" << std::endl;
+    std::cout << "  --scaling <n>       run the scenario with 1..n threads and print the speedup" << std::endl;
+    std::cout << "  --compare <n>       run the scenario with 0..n threads and check the checksums agree, needs --rng counter" << std::endl;
+    std::cout << "  --seed <n>          random seed (default: current time)" << std::endl;
+    std::cout << "  --rng <mode>        fast = per-thread generator, counter = keyed on seed, frame and cell (default: fast)" << std::endl;
+    std::cout << "  --boundary <mode>   wall, wrap = cells leave on one side and come in on the other, sink = cells leave the grid (default: wall)" << std::endl;
+    std::cout << "  --mass              run every scenario, or only --scenario, and check the update never creates or destroys cells" << std::endl;
+    std::cout << "                      of elements that do not react, not with --boundary sink" << std::endl;
+    std::cout << "  --layout            compare cells/sec of the cell_t array and CellGrid at 320x180 and 1280x720" << std::endl;
+    std::cout << "  --list              list available scenarios" << std::endl;
+}
+
+int main(int argc, char** argv) {
+
+    std::string scenarioName = "sand";
+    int frames = DEFAULT_FRAMES;
+    int width = SCREEN_WIDTH / TILE_SIZE;
+    int height = SCREEN_HEIGHT / TILE_SIZE;
+    double dt = DEFAULT_DT;
+    int threads = 0;
+    int scaling = 0;
+    int compare = -1;
+    bool layout = false;
+    bool mass = false;
+    bool scenarioGiven = false;
+    unsigned long long seed = (unsigned long long)time(NULL);
+    RandomMode rngMode = RANDOM_FAST;
+    BoundaryMode boundary = BOUNDARY_WALL;
+
+    for (int i = 1; i < argc; i++) {
+
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--scenario" && hasValue) {
+            scenarioName = argv[++i];
+            scenarioGiven = true;
+        }
+        else if (arg == "--frames" && hasValue) {
+            frames = atoi(argv[++i]);
+        }
+        else if (arg == "--width" && hasValue) {
+            width = atoi(argv[++i]);
+        }
+        else if (arg == "--height" && hasValue) {
+            height = atoi(argv[++i]);
+        }
+        else if (arg == "--dt" && hasValue) {
+            dt = atof(argv[++i]);
+        }
+        else if (arg == "--threads" && hasValue) {
+            threads = atoi(argv[++i]);
+        }
+        else if (arg == "--scaling" && hasValue) {
+            scaling = atoi(argv[++i]);
+        }
+        else if (arg == "--compare" && hasValue) {
+            compare = atoi(argv[++i]);
+        }
+        else if (arg == "--seed" && hasValue) {
+            seed = strtoull(argv[++i], NULL, 10);
+        }
+        else if (arg == "--rng" && hasValue && (std::string(argv[i + 1]) == "fast" || std::string(argv[i + 1]) == "counter")) {
+            rngMode = std::string(argv[++i]) == "counter" ? RANDOM_COUNTER : RANDOM_FAST;
+        }
+        else if (arg == "--boundary" && hasValue && (std::string(argv[i + 1]) == "wall" || std::string(argv[i + 1]) == "wrap" || std::string(argv[i + 1]) == "sink")) {
+
+            std::string mode = argv[++i];
+            boundary = mode == "wrap" ? BOUNDARY_WRAP : (mode == "sink" ? BOUNDARY_SINK : BOUNDARY_WALL);
+        }
+        else if (arg == "--mass") {
+            mass = true;
+        }
+        else if (arg == "--layout") {
+            layout = true;
+        }
+        else if (arg == "--list") {
+
+            for (const Scenario& scenario : GetScenarios())
+                std::cout << scenario.name << " - " << scenario.description << std::endl;
+
+            return 0;
+        }
+        else {
+
+            PrintUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    if (layout) {
+
+        //Each pass sweeps the whole grid once
+        RunLayoutBenchmark(frames);
+        return 0;
+    }
+
+    const Scenario* scenario = FindScenario(scenarioName);
+
+    if (scenario == NULL) {
+
+        std::cout << "Unknown scenario: " << scenarioName << std::endl;
+        return 1;
+    }
+
+    if (frames <= 0 || width <= 0 || height <= 0) {
+
+        std::cout << "Frames, width and height must be positive" << std::endl;
+        return 1;
+    }
+
+    SeedRandom(seed, rngMode);
+
+    if (mass) {
+
+        //Cells leaving the grid are lost on purpose there
+        if (boundary == BOUNDARY_SINK) {
+
+            std::cout << "--mass needs the wall or wrap boundary" << std::endl;
+            return 1;
+        }
+
+        int failed = 0;
+
+        for (const Scenario& each : GetScenarios()) {
+
+            if (scenarioGiven && each.name != scenario->name)
+                continue;
+
+            if (!CheckMass(each, width, height, frames, dt, threads, boundary))
+                failed++;
+        }
+
+        if (!scenarioGiven && !CheckMass(PocketScenario, width, height, frames, dt, threads, boundary))
+            failed++;
+
+        std::cout << (failed ? std::to_string(failed) + " scenario(s) lost or gained cells" : std::string("Every scenario kept its cells")) << std::endl;
+
+        return failed ? 1 : 0;
+    }
+
+    if (compare >= 0) {
+
+        //The fast generator depends on which thread takes which chunk
+        if (rngMode != RANDOM_COUNTER) {
+
+            std::cout << "--compare needs --rng counter" << std::endl;
+            return 1;
+        }
+
+        unsigned long long baseline = 0;
+        bool agree = true;
+
+        for (int t = 0; t <= compare; t++) {
+
+            unsigned long long checksum = 0;
+            RunScenario(*scenario, width, height, frames, dt, t, boundary, NULL, &checksum);
+
+            if (t == 0)
+                baseline = checksum;
+
+            agree = agree && checksum == baseline;
+
+            std::cout << scenario->name << " threads " << t << ": " << std::hex << checksum << std::dec << std::endl;
+        }
+
+        std::cout << (agree ? "Checksums agree" : "Checksums differ") << std::endl;
+
+        return agree ? 0 : 1;
+    }
+
+    if (scaling > 0) {
+
+        std::cout << "Scenario: " << scenario->name << " (" << width << "x" << height << "), " << frames << " frames" << std::endl;
+        std::cout << "threads\tms/frame\tspeedup" << std::endl;
+
+        double baseline = 0.0;
+
+        for (int t = 1; t <= scaling; t++) {
+
+            double seconds = RunScenario(*scenario, width, height, frames, dt, t, boundary);
+
+            if (t == 1)
+                baseline = seconds;
+
+            std::cout << t << "\t" << seconds * 1000.0 / frames << "\t" << baseline / seconds << std::endl;
+        }
+
+        return 0;
+    }
+
+    double cellsPerFrame = 0.0;
+    unsigned long long checksum = 0;
+    double seconds = RunScenario(*scenario, width, height, frames, dt, threads, boundary, &cellsPerFrame, &checksum);
+
+    std::cout << "Scenario: " << scenario->name << " (" << width << "x" << height << ")" << std::endl;
+    std::cout << "Threads: " << threads << std::endl;
+    std::cout << "Seed: " << seed << " (" << (rngMode == RANDOM_COUNTER ? "counter" : "fast") << ")" << std::endl;
+    std::cout << "Frames: " << frames << std::endl;
+    std::cout << "Wall time: " << seconds * 1000.0 << " ms" << std::endl;
+    std::cout << "Per frame: " << seconds * 1000.0 / frames << " ms" << std::endl;
+    std::cout << "Cells visited per frame: " << cellsPerFrame << " of " << width * height << std::endl;
+    std::cout << "Checksum: " << std::hex << checksum << std::dec << std::endl;
+
+    return 0;
+}
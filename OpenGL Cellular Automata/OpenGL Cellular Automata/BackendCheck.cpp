@@ -0,0 +1,90 @@
+#include "BackendCheck.h"
+
+#include "Sandbox.h"
+#include "GpuSandbox.h"
+
+#include <cmath>
+#include <algorithm>
+
+//Cell counts may differ by this fraction plus COUNT_SLACK cells. Gases die and spawn at random, and a tap like the
+//one in the water scenario only adds cells once the spot has drained, which depends on how fast water moves
+#define COUNT_TOLERANCE 0.1
+#define COUNT_SLACK 16
+//Mean rows may differ by this fraction of the grid height, the GPU rules move cells one block at a time
+#define HEIGHT_TOLERANCE 0.05
+
+#define CHECK_DT (1.0 / 100.0)
+
+static const char* s_elementNames[NR_ELEMENTS] = {
+    "empty", "border", "sand", "water", "wood", "stone", "lava", "lava stone", "fire", "ember", "ice", "ash", "magic dust",
+    "smoke", "snow", "steam", "acid", "ceramic", "char", "seed", "leaf", "dirt", "luciferin", "lightning start",
+    "lightning", "gold", "molten gold", "jade"
+};
+
+static ElementCensus Run(SimulationBackend& backend, const Scenario& scenario, int frames, uint64_t seed) {
+
+    SeedRandom(seed, RANDOM_COUNTER);
+
+    backend.UpdateDeltaTime(CHECK_DT);
+    scenario.setup(backend);
+
+    for (int frame = 0; frame < frames; frame++) {
+
+        if (scenario.step)
+            scenario.step(backend, frame);
+
+        backend.Update();
+        backend.ClearLookChanges();
+    }
+
+    return backend.TakeCensus();
+}
+
+BackendCheckResult CheckBackends(const Scenario& scenario, int frames, std::ostream& out) {
+
+    uint64_t seed = GetRandomSeed();
+
+    out << scenario.name << ":" << std::endl;
+
+    Sandbox cpu;
+    ElementCensus start = Run(cpu, scenario, 0, seed);
+
+    for (int i = 0; i < NR_ELEMENTS; i++) {
+
+        if (start.count[i] > 0 && !GpuSandbox::IsPorted((Element)i)) {
+
+            out << "  skipped, " << s_elementNames[i] << " is not ported to the GPU" << std::endl;
+            return CHECK_SKIPPED;
+        }
+    }
+
+    Sandbox cpuRun;
+    GpuSandbox gpuRun;
+
+    ElementCensus a = Run(cpuRun, scenario, frames, seed);
+    ElementCensus b = Run(gpuRun, scenario, frames, seed);
+
+    bool passed = true;
+
+    for (int i = 0; i < NR_ELEMENTS; i++) {
+
+        if (i == EMPTY || (a.count[i] == 0 && b.count[i] == 0))
+            continue;
+
+        double meanA = a.count[i] ? a.heightSum[i] / a.count[i] : 0.0;
+        double meanB = b.count[i] ? b.heightSum[i] / b.count[i] : 0.0;
+
+        long long countSlack = (long long)(COUNT_TOLERANCE * std::max(a.count[i], b.count[i])) + COUNT_SLACK;
+
+        bool countOk = std::llabs(a.count[i] - b.count[i]) <= countSlack;
+        bool heightOk = a.count[i] == 0 || b.count[i] == 0 || std::abs(meanA - meanB) <= HEIGHT_TOLERANCE * cpuRun.height;
+
+        passed = passed && countOk && heightOk;
+
+        out << "  " << s_elementNames[i] << ": cells " << a.count[i] << " cpu / " << b.count[i] << " gpu"
+            << ", mean row " << meanA << " cpu / " << meanB << " gpu"
+            << ((countOk && heightOk) ? "" : "  MISMATCH") << std::endl;
+    }
+
+    return passed ? CHECK_PASSED : CHECK_FAILED;
+}
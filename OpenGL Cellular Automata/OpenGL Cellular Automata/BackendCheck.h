@@ -0,0 +1,11 @@
+#pragma once
+
+#include "Scenario.h"
+#include <ostream>
+
+enum BackendCheckResult { CHECK_PASSED, CHECK_FAILED, CHECK_SKIPPED };
+
+//Runs the scenario on Sandbox and on GpuSandbox from the same seed and compares the element census at the end:
+//the cell count of every element and its mean row. Needs a current OpenGL 4.3 context, llvmpipe is enough.
+//Skipped when the scenario uses an element GpuSandbox does not port
+BackendCheckResult CheckBackends(const Scenario& scenario, int frames, std::ostream& out);
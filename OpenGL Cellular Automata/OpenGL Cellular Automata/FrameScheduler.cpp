@@ -0,0 +1,116 @@
+#include "FrameScheduler.h"
+
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#pragma comment(lib, "winmm.lib")
+#endif
+
+FrameScheduler::FrameScheduler(double tickSeconds, double frameSeconds, int maxSteps)
+    : m_tickSeconds(tickSeconds), m_frameSeconds(frameSeconds), m_maxSteps(maxSteps)
+{
+#ifdef _WIN32
+    //The default timer resolution of 15.6 ms would make every sleep overshoot a 10 ms frame
+    timeBeginPeriod(1);
+#endif
+
+    m_lastFrame = Clock::now();
+    m_nextFrame = m_lastFrame;
+    m_periodStart = m_lastFrame;
+}
+
+FrameScheduler::~FrameScheduler() {
+
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+}
+
+double FrameScheduler::Seconds(Clock::duration duration) {
+
+    return std::chrono::duration<double>(duration).count();
+}
+
+int FrameScheduler::BeginFrame() {
+
+    m_frameStart = Clock::now();
+    m_lastStep = m_frameStart;
+    m_stepsDone = 0;
+
+    m_accumulator += Seconds(m_frameStart - m_lastFrame);
+    m_lastFrame = m_frameStart;
+
+    int steps = (int)(m_accumulator / m_tickSeconds);
+
+    //After a stall the simulation slows down instead of spiralling into ever longer catch-up frames
+    if (steps > m_maxSteps) {
+
+        m_dropped += steps - m_maxSteps;
+        steps = m_maxSteps;
+        m_accumulator = 0.0;
+    }
+    else
+        m_accumulator -= steps * m_tickSeconds;
+
+    m_steps += steps;
+
+    return steps;
+}
+
+void FrameScheduler::StepDone() {
+
+    Clock::time_point now = Clock::now();
+
+    if (m_stepsDone > 0)
+        m_catchUp += Seconds(now - m_lastStep);
+
+    m_lastStep = now;
+    m_stepsDone++;
+}
+
+void FrameScheduler::EndFrame() {
+
+    Clock::time_point workDone = Clock::now();
+    m_busy += Seconds(workDone - m_frameStart);
+
+    m_nextFrame += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(m_frameSeconds));
+
+    //A frame that ran long starts the next one right away, without trying to make up for the lost time
+    if (m_nextFrame < workDone)
+        m_nextFrame = workDone;
+
+    WaitUntil(m_nextFrame);
+
+    Clock::time_point now = Clock::now();
+    m_idle += Seconds(now - workDone);
+    m_frames++;
+
+    if (Seconds(now - m_periodStart) >= 1.0) {
+
+        m_report.idleMs = m_idle * 1000.0 / m_frames;
+        m_report.busyMs = m_busy * 1000.0 / m_frames;
+        m_report.catchUpMs = m_catchUp * 1000.0 / m_frames;
+        m_report.stepsPerFrame = (double)m_steps / m_frames;
+        m_report.droppedSteps = m_dropped;
+
+        m_idle = m_busy = m_catchUp = 0.0;
+        m_steps = m_dropped = m_frames = 0;
+        m_periodStart = now;
+    }
+}
+
+void FrameScheduler::WaitUntil(Clock::time_point deadline) {
+
+    const auto margin = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(SCHEDULER_SLEEP_MARGIN_MS));
+
+    //Sleep away most of the wait, the core is free for other work meanwhile
+    Clock::time_point now = Clock::now();
+
+    if (deadline - now > margin)
+        std::this_thread::sleep_for(deadline - now - margin);
+
+    //Sleeps are not precise, the rest is spent yielding
+    while (Clock::now() < deadline)
+        std::this_thread::yield();
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+
+//Below this much time left before a deadline the scheduler yields instead of sleeping, sleeps overshoot by about this much
+#define SCHEDULER_SLEEP_MARGIN_MS 2.0
+
+//Where the frames of the last report period went, in milliseconds per frame
+typedef struct FrameTimes {
+
+	double idleMs;
+	double busyMs;
+	//Part of busyMs spent on simulation steps after the first one of a frame
+	double catchUpMs;
+	double stepsPerFrame;
+	//Steps thrown away because more than the catch-up cap were due
+	int droppedSteps;
+
+}FrameTimes;
+
+//Runs the simulation at a fixed tick independent of the render rate. Every frame gets the steps the elapsed time
+//accumulated, at most maxSteps, and then waits for the next frame by sleeping and yielding for the last bit
+class FrameScheduler {
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	double m_tickSeconds;
+	double m_frameSeconds;
+	int m_maxSteps;
+
+	double m_accumulator = 0.0;
+	Clock::time_point m_lastFrame;
+	Clock::time_point m_frameStart;
+	Clock::time_point m_nextFrame;
+	Clock::time_point m_lastStep;
+	int m_stepsDone = 0;
+
+	//Sums over the current report period
+	double m_idle = 0.0;
+	double m_busy = 0.0;
+	double m_catchUp = 0.0;
+	int m_steps = 0;
+	int m_dropped = 0;
+	int m_frames = 0;
+	Clock::time_point m_periodStart;
+
+	FrameTimes m_report = {};
+
+public:
+
+	FrameScheduler(double tickSeconds, double frameSeconds, int maxSteps);
+	~FrameScheduler();
+
+	//Number of simulation steps to run before drawing this frame
+	int BeginFrame();
+	//Called after every simulation step, times the catch-up steps
+	void StepDone();
+	//Waits until the next frame is due
+	void EndFrame();
+
+	inline double TickSeconds() const { return m_tickSeconds; }
+	//Averages of the last full second
+	inline const FrameTimes& GetFrameTimes() const { return m_report; }
+
+private:
+
+	static double Seconds(Clock::duration duration);
+	void WaitUntil(Clock::time_point deadline);
+};
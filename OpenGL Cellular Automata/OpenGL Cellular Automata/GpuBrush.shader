@@ -0,0 +1,40 @@
+#shader compute
+#version 430 core
+
+//Writes the cells placed by DrawCircle since the last update. Every target index appears once per batch
+layout(local_size_x = 64) in;
+
+#define EMPTY 0u
+
+struct Cell {
+    uint type;
+    float life;
+    uint look;
+    uint pad;
+};
+
+struct BrushCell {
+    int index;
+    uint type;
+    float life;
+    uint look;
+};
+
+layout(std430, binding = 1) buffer Cells { Cell cells[]; };
+layout(std430, binding = 4) readonly buffer Brush { BrushCell brush[]; };
+
+uniform int u_count;
+
+void main() {
+
+    int i = int(gl_GlobalInvocationID.x);
+
+    if (i >= u_count)
+        return;
+
+    BrushCell b = brush[i];
+
+    //Like Sandbox::AddCell, only the eraser replaces other cells
+    if (b.type == EMPTY || cells[b.index].type == EMPTY)
+        cells[b.index] = Cell(b.type, b.life, b.look, 0u);
+}
@@ -0,0 +1,31 @@
+#shader compute
+#version 430 core
+
+//Fills the renderer's look buffer from the cells. Looks are 16 bit, so every invocation packs two into one uint
+layout(local_size_x = 64) in;
+
+struct Cell {
+    uint type;
+    float life;
+    uint look;
+    uint pad;
+};
+
+layout(std430, binding = 0) writeonly buffer Looks { uint looks[]; };
+layout(std430, binding = 1) readonly buffer Cells { Cell cells[]; };
+
+uniform int u_count;
+
+void main() {
+
+    int i = int(gl_GlobalInvocationID.x);
+    int first = i * 2;
+
+    if (first >= u_count)
+        return;
+
+    uint low = cells[first].look & 0xFFFFu;
+    uint high = first + 1 < u_count ? cells[first + 1].look & 0xFFFFu : 0u;
+
+    looks[i] = low | (high << 16);
+}
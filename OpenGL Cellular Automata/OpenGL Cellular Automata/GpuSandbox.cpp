@@ -0,0 +1,342 @@
+#include "GpuSandbox.h"
+
+#include "ErrorHandling.h"
+#include "ElementTraits.h"
+#include "Sandbox.h"
+
+#include <algorithm>
+#include <cmath>
+
+//Must match Traits in GpuSimulation.shader
+typedef struct GpuTraits {
+
+    unsigned int kernel;
+    unsigned int passableBy;
+    float inertialResistance;
+    float lifeDecay;
+    float smokeChance;
+
+}GpuTraits;
+
+GpuSandbox::GpuSandbox()
+    : GpuSandbox(SCREEN_WIDTH / TILE_SIZE, SCREEN_HEIGHT / TILE_SIZE)
+{
+}
+
+GpuSandbox::GpuSandbox(int width, int height)
+{
+    this->width = width;
+    this->height = height;
+    //GpuLooks.shader writes the rows back to back
+    lookStride = width;
+
+    currentType = STONE;
+
+    m_brushStamps.assign(width * height, 0);
+
+    std::vector<GpuCell> cells(width * height, Pack(cell_empty()));
+
+    GLCall(glGenBuffers(2, m_cellBuffers));
+
+    for (int i = 0; i < 2; i++) {
+
+        GLCall(glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_cellBuffers[i]));
+        GLCall(glBufferData(GL_SHADER_STORAGE_BUFFER, cells.size() * sizeof(GpuCell), cells.data(), GL_DYNAMIC_COPY));
+    }
+
+    GLCall(glGenBuffers(1, &m_brushBuffer));
+    CreateTraits();
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    m_stepShader = new Shader("GpuSimulation.shader");
+    m_brushShader = new Shader("GpuBrush.shader");
+    m_lookShader = new Shader("GpuLooks.shader");
+
+    m_stepShader->Bind();
+    GLCall(glUniform2i(m_stepShader->GetUniformLocation("u_size"), width, height));
+    GLCall(glUniform2f(m_stepShader->GetUniformLocation("u_smokeLife"), 15.f, 30.f));
+    m_stepShader->Unbind();
+}
+
+GpuSandbox::~GpuSandbox() {
+
+    delete m_stepShader;
+    delete m_brushShader;
+    delete m_lookShader;
+
+    GLCall(glDeleteBuffers(2, m_cellBuffers));
+    GLCall(glDeleteBuffers(1, &m_traitBuffer));
+    GLCall(glDeleteBuffers(1, &m_brushBuffer));
+}
+
+bool GpuSandbox::IsSupported() {
+
+    return GLEW_VERSION_4_3 || GLEW_ARB_compute_shader;
+}
+
+bool GpuSandbox::IsPorted(Element type) {
+
+    const ElementTraits& traits = GetTraits(type);
+
+    return traits.kernel != KERNEL_FUEL && traits.fireChance == 0.f;
+}
+
+void GpuSandbox::CreateTraits() {
+
+    GpuTraits traits[NR_ELEMENTS];
+
+    for (int i = 0; i < NR_ELEMENTS; i++) {
+
+        const ElementTraits& t = ELEMENT_TRAITS[i];
+
+        //Unported kernels are left out so those elements do not move
+        traits[i].kernel = IsPorted((Element)i) ? t.kernel : KERNEL_NONE;
+        traits[i].passableBy = t.passableBy;
+        traits[i].inertialResistance = t.inertialResistance;
+        traits[i].lifeDecay = t.lifeDecay;
+        traits[i].smokeChance = t.smokeChance;
+    }
+
+    GLCall(glGenBuffers(1, &m_traitBuffer));
+    GLCall(glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_traitBuffer));
+    GLCall(glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(traits), traits, GL_STATIC_DRAW));
+}
+
+GpuCell GpuSandbox::Pack(const cell_t& cell) const {
+
+    uint8_t shade = (cell.shade & LOOK_HOT) ? HotShade(time) : cell.shade;
+
+    return { (unsigned int)cell.type, cell.life, MakeLook(cell.type, shade), 0 };
+}
+
+void GpuSandbox::SetLookBuffer(unsigned int buffer) {
+
+    m_lookBuffer = buffer;
+
+    //The buffer is created without data, the first frame would show whatever it holds until the first step
+    if (m_lookBuffer)
+        CopyLooks();
+}
+
+void GpuSandbox::UpdateDeltaTime(double dt) {
+
+    //Passes are fixed steps, the CPU rules ported here do not use the time step either. It only advances the clock
+    //the hot looks are stamped with
+    m_dt = dt;
+}
+
+void GpuSandbox::AddCell(int x, int y) {
+
+    if (x < 0 || x >= width || y < 0 || y >= height)
+        return;
+
+    int index = width * y + x;
+    GpuCell cell = Pack(cell_current(currentType));
+    GpuBrushCell brushCell = { index, cell.type, cell.life, cell.look };
+
+    //The first cell placed at an index wins like on the CPU, except the eraser which always wins
+    if (m_brushStamps[index] == m_brushBatch) {
+
+        if (currentType == EMPTY) {
+
+            for (GpuBrushCell& placed : m_brush) {
+
+                if (placed.index == index)
+                    placed = brushCell;
+            }
+        }
+
+        return;
+    }
+
+    m_brushStamps[index] = m_brushBatch;
+    m_brush.push_back(brushCell);
+}
+
+void GpuSandbox::PaintSpans(const CellSpan* spans, int count) {
+
+    bool sprayed = GetTraits(currentType).phase == GAS;
+
+    for (int i = 0; i < count; i++) {
+        for (int x = spans[i].x1; x <= spans[i].x2; x++) {
+
+            SetRandomCell(x, spans[i].y, RANDOM_STREAM_BRUSH);
+
+            //Gases are sprayed into about every fifth cell
+            if (sprayed && RandomFloat(0.f, 1.f) < 0.8f)
+                continue;
+
+            AddCell(x, spans[i].y);
+        }
+    }
+}
+
+void GpuSandbox::FillSpans(const CellSpan* spans, int count, Element type) {
+
+    std::vector<GpuCell> cells;
+
+    for (int i = 0; i < count; i++) {
+
+        for (int x = spans[i].x1; x <= spans[i].x2; x++) {
+
+            SetRandomCell(x, spans[i].y, RANDOM_STREAM_BRUSH);
+            cells.push_back(Pack(cell_current(type)));
+        }
+    }
+
+    //Brush cells placed before the fill go first, the fill overwrites them where they overlap
+    ApplyBrush();
+
+    //The passes and the brush wrote the buffer in shaders, glBufferSubData has to wait for them
+    GLCall(glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT));
+    GLCall(glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_cellBuffers[m_current]));
+
+    //Spans that follow each other in the buffer, like the rows of a full width rectangle, are sent in one call
+    size_t uploaded = 0;
+    int first = 0;
+
+    for (int i = 1; i <= count; i++) {
+
+        if (i < count && width * spans[i].y + spans[i].x1 == width * spans[i - 1].y + spans[i - 1].x2 + 1)
+            continue;
+
+        size_t length = 0;
+        for (int k = first; k < i; k++)
+            length += spans[k].x2 - spans[k].x1 + 1;
+
+        size_t offset = (size_t)(width * spans[first].y + spans[first].x1) * sizeof(GpuCell);
+
+        GLCall(glBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, length * sizeof(GpuCell), &cells[uploaded]));
+
+        uploaded += length;
+        first = i;
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void GpuSandbox::ApplyBrush() {
+
+    if (m_brush.empty())
+        return;
+
+    unsigned int size = (unsigned int)(m_brush.size() * sizeof(GpuBrushCell));
+
+    GLCall(glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_brushBuffer));
+
+    if (size > m_brushCapacity) {
+
+        m_brushCapacity = std::max(size, m_brushCapacity * 2);
+        GLCall(glBufferData(GL_SHADER_STORAGE_BUFFER, m_brushCapacity, nullptr, GL_STREAM_DRAW));
+    }
+
+    GLCall(glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, m_brush.data()));
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    GLCall(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_cellBuffers[m_current]));
+    GLCall(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, m_brushBuffer));
+
+    m_brushShader->Bind();
+    GLCall(glUniform1i(m_brushShader->GetUniformLocation("u_count"), (int)m_brush.size()));
+    m_brushShader->Dispatch(((unsigned int)m_brush.size() + 63) / 64, 1, 1);
+
+    //The next pass reads what the brush wrote
+    GLCall(glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT));
+
+    m_brush.clear();
+    m_brushBatch++;
+
+    if (m_brushBatch == 0) {
+
+        std::fill(m_brushStamps.begin(), m_brushStamps.end(), 0);
+        m_brushBatch = 1;
+    }
+}
+
+void GpuSandbox::Update() {
+
+    SetRandomFrame(frameCount);
+
+    ApplyBrush();
+
+    //Enough 2x2 blocks to cover the grid when they start one cell left of and below it
+    unsigned int blocksX = width / 2 + 1;
+    unsigned int blocksY = height / 2 + 1;
+
+    GLCall(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_traitBuffer));
+
+    m_stepShader->Bind();
+    GLCall(glUniform1ui(m_stepShader->GetUniformLocation("u_seed"), (unsigned int)GetRandomSeed()));
+    GLCall(glUniform1ui(m_stepShader->GetUniformLocation("u_tick"), LookTick(time)));
+    GLCall(glUniform1ui(m_stepShader->GetUniformLocation("u_smokeLook"), MakeLook(SMOKE, HotShade(time))));
+
+    for (int pass = 0; pass < GPU_PASSES_PER_FRAME; pass++) {
+
+        GLCall(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_cellBuffers[m_current]));
+        GLCall(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_cellBuffers[1 - m_current]));
+
+        GLCall(glUniform1i(m_stepShader->GetUniformLocation("u_offset"), (int)((frameCount * GPU_PASSES_PER_FRAME + pass) % 2)));
+        GLCall(glUniform1ui(m_stepShader->GetUniformLocation("u_pass"), (unsigned int)(frameCount * GPU_PASSES_PER_FRAME + pass)));
+        GLCall(glUniform1i(m_stepShader->GetUniformLocation("u_ageGas"), pass == 0));
+
+        m_stepShader->Dispatch((blocksX + 7) / 8, (blocksY + 7) / 8, 1);
+
+        //The next pass reads the buffer this one wrote through a shader storage block
+        GLCall(glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT));
+
+        m_current = 1 - m_current;
+    }
+
+    frameCount++;
+    time += m_dt;
+
+    if (m_lookBuffer)
+        CopyLooks();
+}
+
+void GpuSandbox::CopyLooks() {
+
+    int count = width * height;
+
+    GLCall(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_lookBuffer));
+    GLCall(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_cellBuffers[m_current]));
+
+    m_lookShader->Bind();
+    GLCall(glUniform1i(m_lookShader->GetUniformLocation("u_count"), count));
+    m_lookShader->Dispatch(((count + 1) / 2 + 63) / 64, 1, 1);
+
+    //The renderer copies the look buffer into its texture as a pixel unpack buffer
+    GLCall(glMemoryBarrier(GL_PIXEL_BUFFER_BARRIER_BIT));
+}
+
+ElementCensus GpuSandbox::TakeCensus() {
+
+    ApplyBrush();
+
+    std::vector<GpuCell> cells(width * height);
+
+    //Shader writes have to be visible to glGetBufferSubData
+    GLCall(glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT));
+
+    GLCall(glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_cellBuffers[m_current]));
+    GLCall(glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, cells.size() * sizeof(GpuCell), cells.data()));
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    ElementCensus census = {};
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+
+            unsigned int type = cells[width * y + x].type;
+
+            if (type >= NR_ELEMENTS)
+                continue;
+
+            census.count[type]++;
+            census.heightSum[type] += y;
+        }
+    }
+
+    return census;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "SimulationBackend.h"
+#include "Cells.h"
+#include "Shader.h"
+#include <vector>
+
+//Block passes per Update, the 2x2 blocks start at (0,0) and (1,1) in turn
+#define GPU_PASSES_PER_FRAME 1
+
+//A cell as the compute shaders see it, std430 layout
+typedef struct GpuCell {
+
+	unsigned int type;
+	float life;
+	//look_t, widened to a whole uint
+	unsigned int look;
+	unsigned int pad;
+
+}GpuCell;
+
+//A cell placed by DrawCircle, applied by GpuBrush.shader at the next update
+typedef struct GpuBrushCell {
+
+	int index;
+	unsigned int type;
+	float life;
+	unsigned int look;
+
+}GpuBrushCell;
+
+//Compute shader backend. The cells live in two shader storage buffers, every pass reads one and writes the other.
+//Sand, water and gas rules are ported, other elements stay where they are. Needs OpenGL 4.3
+class GpuSandbox : public SimulationBackend {
+
+private:
+	unsigned int m_cellBuffers[2];
+	//Buffer holding the current state, the other one is written by the next pass
+	int m_current = 0;
+
+	unsigned int m_traitBuffer;
+	unsigned int m_brushBuffer;
+	unsigned int m_brushCapacity = 0;
+
+	//Renderer's look buffer, 0 when nothing is drawn
+	unsigned int m_lookBuffer = 0;
+
+	Shader* m_stepShader;
+	Shader* m_brushShader;
+	Shader* m_lookShader;
+
+	std::vector<GpuBrushCell> m_brush;
+	//Brush batch that last placed a cell at each index, keeps one brush cell per index per batch
+	std::vector<unsigned int> m_brushStamps;
+	unsigned int m_brushBatch = 1;
+
+	unsigned long long frameCount = 0;
+	double m_dt = 0.0;
+
+public:
+
+	GpuSandbox();
+	GpuSandbox(int width, int height);
+	~GpuSandbox() override;
+
+	static bool IsSupported();
+	//Whether the element behaves as on the CPU. Fuel and liquids that spawn fire are not ported
+	static bool IsPorted(Element type);
+
+	//The looks are written into buffer right away and after every Update()
+	void SetLookBuffer(unsigned int buffer);
+
+	void Update() override;
+	void UpdateDeltaTime(double dt) override;
+
+	ElementCensus TakeCensus() override;
+
+protected:
+
+	void PaintSpans(const CellSpan* spans, int count) override;
+	void FillSpans(const CellSpan* spans, int count, Element type) override;
+
+private:
+
+	void CreateTraits();
+	void AddCell(int x, int y);
+	void ApplyBrush();
+	void CopyLooks();
+
+	//Hot cells are stamped with the current time like Sandbox::Spawn does
+	GpuCell Pack(const cell_t& cell) const;
+};
@@ -0,0 +1,215 @@
+#shader compute
+#version 430 core
+
+//One invocation per 2x2 block of cells. The blocks shift by one cell every pass, so each cell is read and
+//written by exactly one invocation and nothing has to be locked. Cells move at most one cell per pass
+layout(local_size_x = 8, local_size_y = 8) in;
+
+//Values of Element and ElementKernel
+#define EMPTY 0u
+#define BORDER 1u
+#define SMOKE 13u
+
+#define KERNEL_POWDER 1u
+#define KERNEL_LIQUID 2u
+#define KERNEL_GAS 4u
+
+#define PASSABLE_BY_SOLID 1u
+
+//Values of the LOOK_ defines in Cells.h
+#define LOOK_HOT 0x80u
+#define LOOK_SPENT 0x40u
+#define LOOK_STAMP_MASK 0x3Fu
+#define LOOK_SPENT_AGE 48u
+
+struct Cell {
+    uint type;
+    float life;
+    uint look;
+    uint pad;
+};
+
+struct Traits {
+    uint kernel;
+    uint passableBy;
+    float inertialResistance;
+    float lifeDecay;
+    float smokeChance;
+};
+
+layout(std430, binding = 1) readonly buffer Source { Cell src[]; };
+layout(std430, binding = 2) writeonly buffer Destination { Cell dst[]; };
+layout(std430, binding = 3) readonly buffer TraitTable { Traits traits[]; };
+
+uniform ivec2 u_size;
+//0 or 1, where the block grid starts
+uniform int u_offset;
+uniform uint u_seed;
+//Frame * passes + pass, keys the random numbers
+uniform uint u_pass;
+//Gases lose life once per frame, on its first pass
+uniform bool u_ageGas;
+
+//Smoke spawned this frame, stamped with the current tick
+uniform uint u_smokeLook;
+uniform uint u_tick;
+uniform vec2 u_smokeLife;
+
+//0 bottom left, 1 bottom right, 2 top left, 3 top right
+Cell c[4];
+bool moved[4];
+
+uint state;
+
+uint Hash(uint x) {
+
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+//Uniform in [0, 1)
+float Random() {
+
+    state = Hash(state);
+    return float(state >> 8) * (1.0 / 16777216.0);
+}
+
+bool RandomBool() { return Random() < 0.5; }
+
+uint Kernel(int i) { return traits[c[i].type].kernel; }
+
+bool IsEmpty(int i) { return c[i].type == EMPTY; }
+
+bool CanMove(int i, uint kernel) { return !moved[i] && Kernel(i) == kernel; }
+
+void Swap(int a, int b) {
+
+    Cell t = c[a];
+    c[a] = c[b];
+    c[b] = t;
+
+    moved[a] = true;
+    moved[b] = true;
+}
+
+void Age(int i) {
+
+    if (Kernel(i) != KERNEL_GAS)
+        return;
+
+    Traits t = traits[c[i].type];
+
+    if (c[i].life <= 0.0) {
+
+        if (t.smokeChance > 0.0 && Random() < t.smokeChance)
+            c[i] = Cell(SMOKE, mix(u_smokeLife.x, u_smokeLife.y, Random()), u_smokeLook, 0u);
+        else
+            c[i] = Cell(EMPTY, 0.0, 0u, 0u);
+
+        return;
+    }
+
+    c[i].life -= t.lifeDecay;
+
+    //Like Sandbox::SettleHot, the stamp would wrap around and the renderer show the gas fresh again
+    uint shade = (c[i].look >> 8) & 0xFFu;
+
+    if ((shade & (LOOK_HOT | LOOK_SPENT)) == LOOK_HOT && ((u_tick - shade) & LOOK_STAMP_MASK) >= LOOK_SPENT_AGE)
+        c[i].look |= LOOK_SPENT << 8;
+}
+
+//Sand falls through anything passable by solids, liquids only into empty cells
+void Fall(int from, int to) {
+
+    if (CanMove(from, KERNEL_POWDER) && (traits[c[to].type].passableBy & PASSABLE_BY_SOLID) != 0u)
+        Swap(from, to);
+    else if (CanMove(from, KERNEL_LIQUID) && IsEmpty(to))
+        Swap(from, to);
+}
+
+//Only sand slides down diagonally, liquids spread sideways instead like Sandbox::UpdateKernel<KERNEL_LIQUID>
+void Slide(int from, int to) {
+
+    if (CanMove(from, KERNEL_POWDER) && (traits[c[to].type].passableBy & PASSABLE_BY_SOLID) != 0u) {
+
+        if (Random() >= traits[c[from].type].inertialResistance)
+            Swap(from, to);
+    }
+}
+
+void Flow(int from, int to) {
+
+    if (CanMove(from, KERNEL_LIQUID) && IsEmpty(to))
+        Swap(from, to);
+}
+
+//Gases drift, half of the time they stay put like on the CPU
+void Rise(int from, int to) {
+
+    if (CanMove(from, KERNEL_GAS) && IsEmpty(to) && RandomBool())
+        Swap(from, to);
+}
+
+void main() {
+
+    ivec2 origin = ivec2(gl_GlobalInvocationID.xy) * 2 - ivec2(u_offset);
+
+    if (origin.x >= u_size.x || origin.y >= u_size.y)
+        return;
+
+    state = Hash(u_seed ^ Hash(u_pass ^ Hash(gl_GlobalInvocationID.y * 65536u + gl_GlobalInvocationID.x)));
+
+    ivec2 p[4] = ivec2[4](origin, origin + ivec2(1, 0), origin + ivec2(0, 1), origin + ivec2(1, 1));
+    bool inside[4];
+
+    for (int i = 0; i < 4; i++) {
+
+        inside[i] = all(greaterThanEqual(p[i], ivec2(0))) && all(lessThan(p[i], u_size));
+
+        //Outside the grid acts as a wall
+        c[i] = inside[i] ? src[p[i].y * u_size.x + p[i].x] : Cell(BORDER, 0.0, 0u, 0u);
+        moved[i] = false;
+    }
+
+    if (u_ageGas) {
+
+        for (int i = 0; i < 4; i++)
+            Age(i);
+    }
+
+    //Columns and rows are visited in a random order so neither side is favoured
+    int first = RandomBool() ? 0 : 1;
+    int second = 1 - first;
+
+    Fall(first + 2, first);
+    Fall(second + 2, second);
+
+    Slide(first + 2, second);
+    Slide(second + 2, first);
+
+    Flow(first, second);
+    Flow(second, first);
+    Flow(first + 2, second + 2);
+    Flow(second + 2, first + 2);
+
+    Rise(first, first + 2);
+    Rise(second, second + 2);
+
+    Rise(first, second + 2);
+    Rise(second, first + 2);
+
+    Rise(first + 2, second + 2);
+    Rise(second + 2, first + 2);
+    Rise(first, second);
+    Rise(second, first);
+
+    for (int i = 0; i < 4; i++) {
+
+        if (inside[i])
+            dst[p[i].y * u_size.x + p[i].x] = c[i];
+    }
+}
@@ -0,0 +1,34 @@
+#shader vertex
+#version 330 core
+
+//Cell coordinates, fractional while in flight
+layout(location = 0) in vec2 a_position;
+layout(location = 1) in uint a_look;
+
+//Cells of the grid, the point is one cell wide
+uniform vec2 u_size;
+
+flat out uint look;
+
+void main() {
+
+    look = a_look;
+    gl_Position = vec4((a_position + 0.5) / u_size * 2.0 - 1.0, 0.0, 1.0);
+}
+
+#shader fragment
+#version 330 core
+
+//Only powder flies, it is never hot, so the element's shade is its color
+flat in uint look;
+
+uniform sampler2D u_palette;
+
+#define LOOK_SHADE_MASK 0x7Fu
+
+out vec4 color;
+
+void main() {
+
+    color = vec4(texelFetch(u_palette, ivec2(int((look >> 8) & LOOK_SHADE_MASK), int(look & 0xFFu)), 0).rgb, 1.0);
+}
@@ -0,0 +1,267 @@
+#include "Renderer.h"
+#include "ErrorHandling.h"
+#include "Palette.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cstddef>
+
+Renderer::Renderer(SimulationBackend& sandbox)
+    : m_sandbox(sandbox), m_time(sandbox.time)
+{
+    GLCall(glGenVertexArrays(1, &m_vao));
+
+    //The buffer has the row layout of the backend's looks
+    unsigned int lookBytes = sandbox.lookStride * sandbox.height * sizeof(look_t);
+
+    //Whole uints, GpuLooks.shader writes two looks at a time
+    ssbo = new ShaderStorageBuffer(nullptr, (lookBytes + 3) & ~3u);
+
+    if (sandbox.looks) {
+
+        ssbo->BeginUpload();
+        ssbo->Upload(0, sandbox.LookCount() * sizeof(look_t), sandbox.looks);
+        ssbo->EndUpload();
+    }
+
+    sandbox.ClearLookChanges();
+
+    CreateTextures(sandbox.width, sandbox.height);
+    CopyRowsToTexture(0, sandbox.height - 1);
+
+    shader = new Shader("VertFrag.shader");
+    shader->Bind();
+
+    GLCall(glUniform1i(shader->GetUniformLocation("u_looks"), 0));
+    GLCall(glUniform1i(shader->GetUniformLocation("u_palette"), 1));
+    GLCall(glUniform1i(shader->GetUniformLocation("u_hotRow"), NR_ELEMENTS));
+
+    shader->Unbind();
+
+    GLCall(glGenVertexArrays(1, &m_particleVao));
+    GLCall(glBindVertexArray(m_particleVao));
+
+    m_particleBuffer = new VertexBuffer(nullptr, 0);
+
+    GLCall(glEnableVertexAttribArray(0));
+    GLCall(glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(FlyingCell), (const void*)offsetof(FlyingCell, x)));
+    GLCall(glEnableVertexAttribArray(1));
+    GLCall(glVertexAttribIPointer(1, 1, GL_UNSIGNED_SHORT, sizeof(FlyingCell), (const void*)offsetof(FlyingCell, look)));
+
+    GLCall(glBindVertexArray(0));
+
+    m_particleShader = new Shader("Particles.shader");
+    m_particleShader->Bind();
+
+    GLCall(glUniform1i(m_particleShader->GetUniformLocation("u_palette"), 1));
+    GLCall(glUniform2f(m_particleShader->GetUniformLocation("u_size"), (float)sandbox.width, (float)sandbox.height));
+
+    m_particleShader->Unbind();
+}
+
+Renderer::~Renderer() {
+
+    GLCall(glBindVertexArray(0));
+
+    delete shader;
+    delete ssbo;
+    delete m_particleShader;
+    delete m_particleBuffer;
+
+    GLCall(glDeleteTextures(1, &m_lookTexture));
+    GLCall(glDeleteTextures(1, &m_paletteTexture));
+    GLCall(glDeleteVertexArrays(1, &m_vao));
+    GLCall(glDeleteVertexArrays(1, &m_particleVao));
+}
+
+void Renderer::CreateTextures(int width, int height) {
+
+    std::vector<uint32_t> palette(PALETTE_WIDTH * PALETTE_HEIGHT);
+    BuildPalette(palette.data());
+
+    GLCall(glGenTextures(1, &m_lookTexture));
+    GLCall(glGenTextures(1, &m_paletteTexture));
+
+    GLCall(glBindTexture(GL_TEXTURE_2D, m_lookTexture));
+    GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_R16UI, width, height, 0, GL_RED_INTEGER, GL_UNSIGNED_SHORT, nullptr));
+
+    GLCall(glBindTexture(GL_TEXTURE_2D, m_paletteTexture));
+    GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, PALETTE_WIDTH, PALETTE_HEIGHT, 0, GL_RGBA, GL_UNSIGNED_BYTE, palette.data()));
+
+    //Both are only read with texelFetch, integer textures still need a filter that does not use mipmaps
+    unsigned int textures[2] = { m_lookTexture, m_paletteTexture };
+
+    for (unsigned int texture : textures) {
+
+        GLCall(glBindTexture(GL_TEXTURE_2D, texture));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+        GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void Renderer::CopyRowsToTexture(int firstRow, int lastRow) {
+
+    const int width = m_sandbox.width;
+    const unsigned int rowBytes = m_sandbox.lookStride * sizeof(look_t);
+
+    //The look buffer is used as the pixel source, so nothing crosses the bus. The row length skips the cells the
+    //backend keeps between rows
+    GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, ssbo->GetID()));
+    GLCall(glBindTexture(GL_TEXTURE_2D, m_lookTexture));
+
+    //Rows of an odd width end halfway through a 4 byte word
+    GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 2));
+    GLCall(glPixelStorei(GL_UNPACK_ROW_LENGTH, m_sandbox.lookStride));
+    GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, firstRow, width, lastRow - firstRow + 1, GL_RED_INTEGER, GL_UNSIGNED_SHORT, (const void*)(size_t)(firstRow * rowBytes)));
+    GLCall(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+    GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+void Renderer::UploadLooks() {
+
+    m_time = m_sandbox.time;
+
+    //The backend writes the look buffer itself
+    if (m_sandbox.looks == nullptr) {
+
+        CopyRowsToTexture(0, m_sandbox.height - 1);
+        UploadFlyingCells(m_sandbox.flyingCells);
+        return;
+    }
+
+    std::vector<int>& changed = m_sandbox.changedCells;
+    const unsigned int cellBytes = sizeof(look_t);
+    const int width = m_sandbox.width;
+    const int stride = m_sandbox.lookStride;
+    const int numCells = width * m_sandbox.height;
+
+    //Rows replaced by region writes go up as one range
+    const int rowMin = m_sandbox.changedRowMin;
+    const int rowMax = m_sandbox.changedRowMax;
+    const bool hasRows = rowMin <= rowMax;
+
+    //Rows the texture has to be refreshed for
+    int firstRow = m_sandbox.height;
+    int lastRow = -1;
+
+    ssbo->BeginUpload();
+
+    //When most of the grid changed a single full upload is cheaper than sorting and merging ranges
+    if ((int)changed.size() >= numCells / 2 || (hasRows && rowMax - rowMin + 1 >= m_sandbox.height / 2)) {
+
+        ssbo->Upload(0, m_sandbox.LookCount() * cellBytes, m_sandbox.looks);
+
+        firstRow = 0;
+        lastRow = m_sandbox.height - 1;
+    }
+    else {
+
+        std::sort(changed.begin(), changed.end());
+
+        if (hasRows) {
+
+            ssbo->Upload(rowMin * stride * cellBytes, ((rowMax - rowMin) * stride + width) * cellBytes, &m_sandbox.looks[rowMin * stride]);
+
+            firstRow = rowMin;
+            lastRow = rowMax;
+
+            //Cells in those rows were just sent
+            changed.erase(std::lower_bound(changed.begin(), changed.end(), rowMin * stride),
+                std::lower_bound(changed.begin(), changed.end(), (rowMax + 1) * stride));
+        }
+
+        if (!changed.empty()) {
+
+            firstRow = std::min(firstRow, changed.front() / stride);
+            lastRow = std::max(lastRow, changed.back() / stride);
+
+            int first = changed[0];
+            int last = changed[0];
+
+            for (size_t i = 1; i < changed.size(); i++) {
+
+                if (changed[i] - last <= UPLOAD_MERGE_GAP) {
+
+                    last = changed[i];
+                    continue;
+                }
+
+                ssbo->Upload(first * cellBytes, (last - first + 1) * cellBytes, &m_sandbox.looks[first]);
+
+                first = changed[i];
+                last = changed[i];
+            }
+
+            ssbo->Upload(first * cellBytes, (last - first + 1) * cellBytes, &m_sandbox.looks[first]);
+        }
+    }
+
+    ssbo->EndUpload();
+
+    if (firstRow <= lastRow)
+        CopyRowsToTexture(firstRow, lastRow);
+
+    m_sandbox.ClearLookChanges();
+
+    UploadFlyingCells(m_sandbox.flyingCells);
+}
+
+void Renderer::UploadRows(const look_t* looks, int firstRow, int lastRow, double time) {
+
+    m_time = time;
+
+    const int width = m_sandbox.width;
+    const int stride = m_sandbox.lookStride;
+
+    ssbo->BeginUpload();
+
+    if (firstRow <= lastRow)
+        ssbo->Upload(firstRow * stride * sizeof(look_t), ((lastRow - firstRow) * stride + width) * sizeof(look_t), &looks[firstRow * stride]);
+
+    ssbo->EndUpload();
+
+    if (firstRow <= lastRow)
+        CopyRowsToTexture(firstRow, lastRow);
+}
+
+void Renderer::UploadFlyingCells(const std::vector<FlyingCell>& cells) {
+
+    m_particleCount = (int)cells.size();
+
+    if (m_particleCount > 0)
+        m_particleBuffer->UpdateVertex(cells.data(), m_particleCount * sizeof(FlyingCell));
+}
+
+void Renderer::Draw() {
+
+    GLCall(glBindVertexArray(m_vao));
+    shader->Bind();
+
+    //Burning, fire and smoke cells change color with this alone, nothing is uploaded for them
+    GLCall(glUniform1ui(shader->GetUniformLocation("u_tick"), LookTick(m_time)));
+
+    GLCall(glActiveTexture(GL_TEXTURE0));
+    GLCall(glBindTexture(GL_TEXTURE_2D, m_lookTexture));
+    GLCall(glActiveTexture(GL_TEXTURE1));
+    GLCall(glBindTexture(GL_TEXTURE_2D, m_paletteTexture));
+    GLCall(glActiveTexture(GL_TEXTURE0));
+
+    GLCall(glDrawArrays(GL_TRIANGLES, 0, 3));
+
+    if (m_particleCount == 0)
+        return;
+
+    GLCall(glBindVertexArray(m_particleVao));
+    m_particleShader->Bind();
+
+    //The palette is still bound to unit 1
+    GLCall(glPointSize((float)TILE_SIZE));
+    GLCall(glDrawArrays(GL_POINTS, 0, m_particleCount));
+}
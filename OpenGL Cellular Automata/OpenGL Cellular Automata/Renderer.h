@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Sandbox.h"
+#include "Shader.h"
+#include "ShaderStorageBuffer.h"
+#include "VertexBuffer.h"
+
+//Dirty cells closer than this are uploaded as one range, re-sending the clean cells in between
+#define UPLOAD_MERGE_GAP 16
+
+class Renderer {
+
+private:
+	SimulationBackend& m_sandbox;
+
+	//Empty, the fullscreen triangle is built from gl_VertexID
+	unsigned int m_vao;
+
+	//One look per texel and cell, the fragment shader scales it up by TILE_SIZE
+	unsigned int m_lookTexture;
+	//Colors of every look, see BuildPalette
+	unsigned int m_paletteTexture;
+
+	//Looks are uploaded here first, then copied into the texture on the GPU
+	ShaderStorageBuffer* ssbo;
+	Shader* shader;
+
+	//Cells in flight, drawn as points over the grid
+	unsigned int m_particleVao;
+	VertexBuffer* m_particleBuffer;
+	Shader* m_particleShader;
+	int m_particleCount = 0;
+
+	//Simulated seconds of the uploaded looks, the hot looks are aged by it
+	double m_time;
+
+public:
+
+	Renderer(SimulationBackend& sandbox);
+	~Renderer();
+
+	void UploadLooks();
+	//Uploads rows of a copy of the looks with the backend's row layout, for backends stepped on another thread
+	void UploadRows(const look_t* looks, int firstRow, int lastRow, double time);
+	//Replaces the cells in flight, a few hundred at most, so all of them go up every frame
+	void UploadFlyingCells(const std::vector<FlyingCell>& cells);
+	void Draw();
+
+	inline const UploadStats& GetUploadStats() const { return ssbo->GetStats(); }
+	//Per-cell look buffer copied into the texture, for backends that write the looks on the GPU
+	inline unsigned int GetLookBuffer() const { return ssbo->GetID(); }
+
+private:
+
+	void CreateTextures(int width, int height);
+	void CopyRowsToTexture(int firstRow, int lastRow);
+};
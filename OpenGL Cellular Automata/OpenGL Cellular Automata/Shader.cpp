@@ -13,7 +13,12 @@ Shader::Shader(const std::string& filepath)
 {
 
     ShaderSources source = ParseShader(filepath);
-    m_rendererID = CreateShader(source.VertexSource, source.FragmentSource);
+
+    //A file with a #shader compute section is a compute program, otherwise a vertex and fragment pair
+    if (!source.ComputeSource.empty())
+        m_rendererID = CreateComputeShader(source.ComputeSource);
+    else
+        m_rendererID = CreateShader(source.VertexSource, source.FragmentSource);
 
     uMVPlocation = glGetUniformLocation(m_rendererID, "u_MVP");
 }
@@ -29,11 +34,11 @@ ShaderSources Shader::ParseShader(const std::string& filePath) {
 
     enum class ShaderType {
 
-        NONE = -1, VERTEX = 0, FRAGMENT = 1
+        NONE = -1, VERTEX = 0, FRAGMENT = 1, COMPUTE = 2
     };
 
     std::string line;
-    std::stringstream ss[2];
+    std::stringstream ss[3];
     ShaderType type = ShaderType::NONE;
     while (getline(stream, line)) {
 
@@ -47,14 +52,18 @@ ShaderSources Shader::ParseShader(const std::string& filePath) {
 
                 type = ShaderType::FRAGMENT;
             }
+            else if (line.find("compute") != std::string::npos) {
+
+                type = ShaderType::COMPUTE;
+            }
         }
-        else {
+        else if (type != ShaderType::NONE) {
 
             ss[(int)type] << line << '\n';
         }
     }
 
-    return { ss[0].str(), ss[1].str() };
+    return { ss[0].str(), ss[1].str(), ss[2].str() };
 }
 
 unsigned int Shader::CompileShader(unsigned int type, std::string& source) {
@@ -82,7 +91,7 @@ unsigned int Shader::CompileShader(unsigned int type, std::string& source) {
 
         glGetShaderInfoLog(id, length, &length, message);
 
-        std::cout << "Failed to compile " << (type == GL_VERTEX_SHADER ? "vertex" : "fragment") << " shader" << std::endl;
+        std::cout << "Failed to compile " << (type == GL_VERTEX_SHADER ? "vertex" : type == GL_COMPUTE_SHADER ? "compute" : "fragment") << " shader" << std::endl;
         std::cout << message << std::endl;
 
         glDeleteShader(id);
@@ -110,6 +119,25 @@ int Shader::CreateShader(std::string& vertexShader, std::string& fragmentShader)
     return program;
 }
 
+int Shader::CreateComputeShader(std::string& computeShader) {
+
+    unsigned int program = glCreateProgram();
+    unsigned int cs = CompileShader(GL_COMPUTE_SHADER, computeShader);
+
+    glAttachShader(program, cs);
+    glLinkProgram(program);
+
+    int result;
+    glGetProgramiv(program, GL_LINK_STATUS, &result);
+
+    if (result == GL_FALSE)
+        std::cout << "Failed to link compute shader " << m_filepath << std::endl;
+
+    glDeleteShader(cs);
+
+    return program;
+}
+
 void Shader::Bind() const
 {
     GLCall(glUseProgram(m_rendererID));
@@ -119,3 +147,14 @@ void Shader::Unbind() const
 {
     GLCall(glUseProgram(0));
 }
+
+int Shader::GetUniformLocation(const char* name) const
+{
+    return glGetUniformLocation(m_rendererID, name);
+}
+
+void Shader::Dispatch(unsigned int groupsX, unsigned int groupsY, unsigned int groupsZ) const
+{
+    Bind();
+    GLCall(glDispatchCompute(groupsX, groupsY, groupsZ));
+}
@@ -5,6 +5,7 @@ struct ShaderSources {
 
 	std::string VertexSource;
 	std::string FragmentSource;
+	std::string ComputeSource;
 };
 
 class Shader {
@@ -21,6 +22,11 @@ public:
 	void Bind() const;
 	void Unbind() const;
 
+	int GetUniformLocation(const char* name) const;
+
+	//Compute programs only, binds the program and dispatches the given number of work groups
+	void Dispatch(unsigned int groupsX, unsigned int groupsY, unsigned int groupsZ) const;
+
 	int uMVPlocation;
 
 private:
@@ -28,5 +34,6 @@ private:
 	ShaderSources ParseShader(const std::string& filePath);
 	unsigned int CompileShader(unsigned int type, std::string& source);
 	int CreateShader(std::string& vertexShader, std::string& fragmentShader);
+	int CreateComputeShader(std::string& computeShader);
 
 };
\ No newline at end of file
@@ -1,8 +1,13 @@
 #include "ShaderStorageBuffer.h"
 
 #include "ErrorHandling.h"
+#include <cstring>
 
-ShaderStorageBuffer::ShaderStorageBuffer(const void* data, unsigned int size) {
+ShaderStorageBuffer::ShaderStorageBuffer(const void* data, unsigned int size)
+    : m_size(size), m_ringID(0), m_ringData(nullptr), m_segment(0), m_segmentCursor(0), m_stats{ 0, 0 }
+{
+    for (int i = 0; i < RING_SEGMENTS; i++)
+        m_fences[i] = 0;
 
     glGenBuffers(1, &m_rendererID);
 
@@ -11,10 +16,45 @@ ShaderStorageBuffer::ShaderStorageBuffer(const void* data, unsigned int size) {
     glBufferData(GL_SHADER_STORAGE_BUFFER, size, data, GL_DYNAMIC_DRAW);
 
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_rendererID);
+
+    //Without buffer storage fall back to plain glBufferSubData uploads
+    if (GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage) {
+
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+        GLCall(glGenBuffers(1, &m_ringID));
+        GLCall(glBindBuffer(GL_COPY_READ_BUFFER, m_ringID));
+        GLCall(glBufferStorage(GL_COPY_READ_BUFFER, (GLsizeiptr)size * RING_SEGMENTS, nullptr, flags));
+
+        m_ringData = (char*)glMapBufferRange(GL_COPY_READ_BUFFER, 0, (GLsizeiptr)size * RING_SEGMENTS, flags);
+
+        if (m_ringData == nullptr) {
+
+            GLCall(glDeleteBuffers(1, &m_ringID));
+            m_ringID = 0;
+        }
+
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    }
 }
 
 ShaderStorageBuffer::~ShaderStorageBuffer() {
 
+    for (int i = 0; i < RING_SEGMENTS; i++) {
+
+        if (m_fences[i])
+            glDeleteSync(m_fences[i]);
+    }
+
+    if (m_ringID) {
+
+        glBindBuffer(GL_COPY_READ_BUFFER, m_ringID);
+        glUnmapBuffer(GL_COPY_READ_BUFFER);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+        GLCall(glDeleteBuffers(1, &m_ringID));
+    }
+
     GLCall(glDeleteBuffers(1, &m_rendererID));
 }
 
@@ -28,7 +68,72 @@ void ShaderStorageBuffer::Unbind() const {
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 }
 
-void ShaderStorageBuffer::UpdateColors(int offset, unsigned int size, float* data) const {
+void ShaderStorageBuffer::BeginUpload() {
+
+    m_stats = { 0, 0 };
+
+    Bind();
+
+    if (!IsPersistentlyMapped())
+        return;
+
+    //Wait until the GPU has finished copying out of the segment we are about to overwrite
+    GLsync& fence = m_fences[m_segment];
+
+    if (fence) {
+
+        while (true) {
+
+            GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+
+            if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED)
+                break;
+        }
+
+        glDeleteSync(fence);
+        fence = 0;
+    }
+
+    m_segmentCursor = 0;
+
+    glBindBuffer(GL_COPY_READ_BUFFER, m_ringID);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_rendererID);
+}
+
+void ShaderStorageBuffer::Upload(unsigned int offset, unsigned int size, const void* data) {
+
+    if (size == 0)
+        return;
+
+    if (IsPersistentlyMapped() && m_segmentCursor + size <= m_size) {
+
+        unsigned int ringOffset = m_segment * m_size + m_segmentCursor;
+
+        memcpy(m_ringData + ringOffset, data, size);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, ringOffset, offset, size);
 
-    glBufferSubData(GL_SHADER_STORAGE_BUFFER, offset * 4 * sizeof(float), size, &data[offset * 4]);
-}
\ No newline at end of file
+        m_segmentCursor += size;
+    }
+    else {
+
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, size, data);
+    }
+
+    m_stats.calls++;
+    m_stats.bytes += size;
+}
+
+void ShaderStorageBuffer::EndUpload() {
+
+    if (!IsPersistentlyMapped())
+        return;
+
+    if (m_segmentCursor > 0) {
+
+        m_fences[m_segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        m_segment = (m_segment + 1) % RING_SEGMENTS;
+    }
+
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
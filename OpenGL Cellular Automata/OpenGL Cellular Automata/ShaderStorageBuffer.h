@@ -1,8 +1,31 @@
 #pragma once
+#include <GL/glew.h>
+
+//Number of frames the persistently mapped staging ring can have in flight
+#define RING_SEGMENTS 3
+
+typedef struct UploadStats {
+
+	unsigned int calls;
+	unsigned int bytes;
+
+}UploadStats;
+
 class ShaderStorageBuffer {
 
 private:
 	unsigned m_rendererID;
+	unsigned int m_size;
+
+	//Persistently mapped staging buffer, split into RING_SEGMENTS segments of m_size bytes
+	unsigned m_ringID;
+	char* m_ringData;
+	GLsync m_fences[RING_SEGMENTS];
+	int m_segment;
+	unsigned int m_segmentCursor;
+
+	UploadStats m_stats;
+
 public:
 	ShaderStorageBuffer(const void* data, unsigned int size);
 	~ShaderStorageBuffer();
@@ -10,5 +33,13 @@ public:
 	void Bind() const;
 	void Unbind() const;
 
-	void UpdateColors(int offset, unsigned int size, float* data) const;
-};
\ No newline at end of file
+	//Batched uploads - every Upload between BeginUpload and EndUpload goes through the same ring segment
+	void BeginUpload();
+	void Upload(unsigned int offset, unsigned int size, const void* data);
+	void EndUpload();
+
+	inline bool IsPersistentlyMapped() const { return m_ringData != nullptr; }
+	inline unsigned int GetID() const { return m_rendererID; }
+	inline unsigned int GetSize() const { return m_size; }
+	inline const UploadStats& GetStats() const { return m_stats; }
+};
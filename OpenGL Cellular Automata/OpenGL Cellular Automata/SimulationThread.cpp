@@ -0,0 +1,182 @@
+#include "SimulationThread.h"
+
+#include <algorithm>
+#include <cstring>
+
+void ApplyInput(SimulationBackend& backend, const SimulationInput& input) {
+
+    if (input.draw && input.stroke)
+        backend.DrawStroke(input.fromX, input.fromY, input.x, input.y, input.radius);
+    else if (input.draw)
+        backend.DrawCircle(input.x, input.y, input.radius);
+
+    backend.currentType = input.type;
+
+    if (input.fill)
+        backend.FillScreen();
+}
+
+SimulationThread::SimulationThread(SimulationBackend& backend, double tickSeconds, int maxSteps)
+    : m_backend(backend), m_scheduler(tickSeconds, tickSeconds, maxSteps)
+{
+    for (int i = 0; i < 3; i++) {
+
+        SimulationFrame& frame = m_frames.Slot(i);
+
+        frame.looks.assign(backend.looks, backend.looks + backend.LookCount());
+        frame.sequence = 0;
+        frame.time = backend.time;
+        frame.times = {};
+
+        std::fill(frame.firstRow, frame.firstRow + FRAME_HISTORY, backend.height);
+        std::fill(frame.lastRow, frame.lastRow + FRAME_HISTORY, -1);
+
+        m_staleFirst[i] = backend.height;
+        m_staleLast[i] = -1;
+    }
+
+    std::fill(m_historyFirst, m_historyFirst + FRAME_HISTORY, backend.height);
+    std::fill(m_historyLast, m_historyLast + FRAME_HISTORY, -1);
+
+    backend.UpdateDeltaTime(tickSeconds);
+
+    m_thread = std::thread(&SimulationThread::Run, this);
+}
+
+SimulationThread::~SimulationThread() {
+
+    m_stop.store(true);
+    m_thread.join();
+}
+
+void SimulationThread::Submit(const SimulationInput& input) {
+
+    std::lock_guard<std::mutex> lock(m_inputMutex);
+    m_inputs.push_back(input);
+}
+
+bool SimulationThread::ApplyInputs() {
+
+    std::vector<SimulationInput> inputs;
+
+    {
+        std::lock_guard<std::mutex> lock(m_inputMutex);
+        inputs.swap(m_inputs);
+    }
+
+    for (const SimulationInput& input : inputs)
+        ApplyInput(m_backend, input);
+
+    return !inputs.empty();
+}
+
+void SimulationThread::Run() {
+
+    while (!m_stop.load()) {
+
+        int steps = m_scheduler.BeginFrame();
+
+        bool changed = ApplyInputs();
+
+        for (int step = 0; step < steps; step++) {
+
+            m_backend.Update();
+            m_scheduler.StepDone();
+        }
+
+        if (changed || steps > 0)
+            Publish();
+
+        m_scheduler.EndFrame();
+    }
+}
+
+void SimulationThread::Publish() {
+
+    const int stride = m_backend.lookStride;
+    std::vector<int>& changed = m_backend.changedCells;
+
+    //Rows the publish changes
+    int firstRow = m_backend.height;
+    int lastRow = -1;
+
+    if (!changed.empty()) {
+
+        auto range = std::minmax_element(changed.begin(), changed.end());
+        firstRow = *range.first / stride;
+        lastRow = *range.second / stride;
+    }
+
+    firstRow = std::min(firstRow, m_backend.changedRowMin);
+    lastRow = std::max(lastRow, m_backend.changedRowMax);
+
+    m_backend.ClearLookChanges();
+
+    m_sequence++;
+    m_historyFirst[m_sequence % FRAME_HISTORY] = firstRow;
+    m_historyLast[m_sequence % FRAME_HISTORY] = lastRow;
+
+    for (int i = 0; i < 3; i++) {
+
+        m_staleFirst[i] = std::min(m_staleFirst[i], firstRow);
+        m_staleLast[i] = std::max(m_staleLast[i], lastRow);
+    }
+
+    //The back slot was last filled two or more publishes ago, only the rows changed since are copied into it
+    int slot = m_frames.BackIndex();
+    SimulationFrame& frame = m_frames.Back();
+
+    if (m_staleFirst[slot] <= m_staleLast[slot]) {
+
+        int offset = m_staleFirst[slot] * stride;
+        int count = (m_staleLast[slot] - m_staleFirst[slot]) * stride + m_backend.width;
+
+        std::memcpy(&frame.looks[offset], &m_backend.looks[offset], count * sizeof(look_t));
+    }
+
+    m_staleFirst[slot] = m_backend.height;
+    m_staleLast[slot] = -1;
+
+    frame.sequence = m_sequence;
+
+    for (int k = 0; k < FRAME_HISTORY; k++) {
+
+        frame.firstRow[k] = m_historyFirst[(m_sequence - k) % FRAME_HISTORY];
+        frame.lastRow[k] = m_historyLast[(m_sequence - k) % FRAME_HISTORY];
+    }
+
+    frame.flyingCells = m_backend.flyingCells;
+    frame.time = m_backend.time;
+    frame.times = m_scheduler.GetFrameTimes();
+
+    m_frames.Publish();
+}
+
+bool SimulationThread::AcquireFrame(int& firstRow, int& lastRow) {
+
+    if (!m_frames.Acquire())
+        return false;
+
+    const SimulationFrame& frame = m_frames.Front();
+    unsigned long long missed = frame.sequence - m_acquired;
+
+    m_acquired = frame.sequence;
+
+    if (missed > FRAME_HISTORY) {
+
+        firstRow = 0;
+        lastRow = m_backend.height - 1;
+        return true;
+    }
+
+    firstRow = m_backend.height;
+    lastRow = -1;
+
+    for (unsigned long long k = 0; k < missed; k++) {
+
+        firstRow = std::min(firstRow, frame.firstRow[k]);
+        lastRow = std::max(lastRow, frame.lastRow[k]);
+    }
+
+    return true;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "SimulationBackend.h"
+#include "FrameScheduler.h"
+#include "TripleBuffer.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Frames remember which rows changed in this many publishes, a reader further behind re-uploads everything
+#define FRAME_HISTORY 8
+
+//Brush and key input of one rendered frame
+typedef struct SimulationInput {
+
+	bool draw;
+	int x, y, radius;
+	//Sweeps the brush from the previous frame's position, the mouse is only sampled once per frame
+	bool stroke;
+	int fromX, fromY;
+
+	Element type;
+	bool fill;
+
+}SimulationInput;
+
+//Applies the input like the window did before the simulation had its own thread, the brush first with the old type
+void ApplyInput(SimulationBackend& backend, const SimulationInput& input);
+
+//Looks of the whole grid after a simulation frame, rows lookStride apart like the backend's
+typedef struct SimulationFrame {
+
+	std::vector<look_t> looks;
+	//Drawn over the looks, whole every publish
+	std::vector<FlyingCell> flyingCells;
+	//Number of the publish, counting from 1
+	unsigned long long sequence;
+	//firstRow[k] to lastRow[k] changed in publish sequence - k, empty when firstRow > lastRow
+	int firstRow[FRAME_HISTORY];
+	int lastRow[FRAME_HISTORY];
+
+	double time;
+	//Of the simulation thread, the window reports them next to its own
+	FrameTimes times;
+
+}SimulationFrame;
+
+//Steps a CPU backend on its own thread at a fixed tick and hands the finished looks to the render thread through a
+//triple buffer, so drawing and swapping never hold the simulation up and the other way round. The backend must not
+//be touched by anyone else while this exists
+class SimulationThread {
+
+private:
+	SimulationBackend& m_backend;
+	FrameScheduler m_scheduler;
+
+	TripleBuffer<SimulationFrame> m_frames;
+
+	//Simulation thread only
+	unsigned long long m_sequence = 0;
+	int m_historyFirst[FRAME_HISTORY];
+	int m_historyLast[FRAME_HISTORY];
+	//Rows every slot misses, written since the slot was last filled
+	int m_staleFirst[3];
+	int m_staleLast[3];
+
+	//Render thread only
+	unsigned long long m_acquired = 0;
+
+	std::mutex m_inputMutex;
+	std::vector<SimulationInput> m_inputs;
+
+	std::atomic<bool> m_stop{ false };
+	std::thread m_thread;
+
+public:
+
+	//The backend's looks must be current, the renderer uploaded them already
+	SimulationThread(SimulationBackend& backend, double tickSeconds, int maxSteps);
+	//Stops and joins the thread
+	~SimulationThread();
+
+	//Applied on the simulation thread before its next step
+	void Submit(const SimulationInput& input);
+
+	//Takes the newest published frame. False when nothing was published since the last call, otherwise the rows that
+	//changed since the previously taken frame, firstRow > lastRow when none did
+	bool AcquireFrame(int& firstRow, int& lastRow);
+	inline const SimulationFrame& Frame() const { return m_frames.Front(); }
+
+private:
+
+	void Run();
+	bool ApplyInputs();
+	void Publish();
+};
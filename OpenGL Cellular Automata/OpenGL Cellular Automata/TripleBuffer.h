@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+
+//Set in the shared index while the slot behind it was published and not yet taken by the reader
+#define TRIPLE_BUFFER_FRESH 4
+#define TRIPLE_BUFFER_INDEX 3
+
+//One writer and one reader exchanging whole values without locks. The writer fills the back slot and publishes it,
+//the reader takes the newest published slot. Neither ever waits for the other, frames the reader was too slow
+//for are overwritten
+template<typename T>
+class TripleBuffer {
+
+private:
+	T m_slots[3];
+
+	int m_back = 0;
+	//The slot between the two, swapped with the writer's or the reader's slot
+	std::atomic<int> m_middle{ 1 };
+	int m_front = 2;
+
+public:
+
+	//Writer side
+	inline T& Back() { return m_slots[m_back]; }
+	inline int BackIndex() const { return m_back; }
+
+	void Publish() {
+
+		m_back = m_middle.exchange(m_back | TRIPLE_BUFFER_FRESH, std::memory_order_acq_rel) & TRIPLE_BUFFER_INDEX;
+	}
+
+	//Reader side, false when nothing was published since the last call
+	bool Acquire() {
+
+		if ((m_middle.load(std::memory_order_acquire) & TRIPLE_BUFFER_FRESH) == 0)
+			return false;
+
+		m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & TRIPLE_BUFFER_INDEX;
+		return true;
+	}
+
+	inline const T& Front() const { return m_slots[m_front]; }
+
+	//Only while neither thread is running
+	inline T& Slot(int i) { return m_slots[i]; }
+};
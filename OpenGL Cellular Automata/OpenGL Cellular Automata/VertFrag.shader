@@ -1,26 +1,69 @@
 #shader vertex
 #version 330 core
 
-layout(location = 0) in vec2 position;
-
-uniform mat4 u_MVP;
-
+out vec2 texCoord;
 
+//One triangle covering the screen, built from the vertex index so no vertex buffer is needed
 void main() {
 
-    gl_Position = u_MVP * vec4(position, 0.0, 1.0);
-};
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+
+    texCoord = position;
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
 
 #shader fragment
-#version 430 core
+#version 330 core
 
-layout(std430, binding = 0) buffer Colors {
-    vec4 colors[];
-};
+in vec2 texCoord;
+
+//Values of the LOOK_ defines in Cells.h
+#define LOOK_HOT 0x80u
+#define LOOK_SPENT 0x40u
+#define LOOK_STAMP_MASK 0x3Fu
+#define LOOK_SHADE_MASK 0x7Fu
+#define LOOK_SPENT_AGE 48u
+
+//One look per cell, the element in the low byte and its shade byte in the high byte
+uniform usampler2D u_looks;
+//Row type has the element's shades, row u_hotRow + type its colors while burning or glowing by age
+uniform sampler2D u_palette;
+uniform int u_hotRow;
+//LookTick of the backend's time, what hot cells are aged against
+uniform uint u_tick;
 
 out vec4 color;
 
+uint Hash(uint x) {
+
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
 void main() {
 
-    color = colors[gl_PrimitiveID / 2];
-};
\ No newline at end of file
+    ivec2 cell = ivec2(texCoord * vec2(textureSize(u_looks, 0)));
+    uint look = texelFetch(u_looks, cell, 0).r;
+
+    int type = int(look & 0xFFu);
+    uint shade = look >> 8;
+
+    if ((shade & LOOK_HOT) == 0u) {
+
+        color = vec4(texelFetch(u_palette, ivec2(int(shade & LOOK_SHADE_MASK), type), 0).rgb, 1.0);
+        return;
+    }
+
+    //Hot cells are animated here, the simulation only stamps them once
+    uint age = (shade & LOOK_SPENT) != 0u ? LOOK_SPENT_AGE : min((u_tick - shade) & LOOK_STAMP_MASK, LOOK_SPENT_AGE);
+    vec4 hot = texelFetch(u_palette, ivec2(int(age), u_hotRow + type), 0);
+
+    //Every cell flickers on its own, a new brightness each tick
+    float flicker = float(Hash(uint(cell.y * 65536 + cell.x) ^ Hash(u_tick)) >> 8) * (1.0 / 16777216.0) * 2.0 - 1.0;
+
+    color = vec4(hot.rgb * (1.0 + 0.5 * hot.a * flicker), 1.0);
+}
@@ -5,21 +5,25 @@
 #include <fstream>
 #include <string>
 #include <sstream>
+#include <cstdlib>
 
 #include "ErrorHandling.h"
-#include "VertexBuffer.h"
-#include "IndexBuffer.h"
-#include "ShaderStorageBuffer.h"
 #include <vector>
 
-#include <glm/glm.hpp>
-#include <glm/gtc/matrix_transform.hpp>
-
-#include "Shader.h"
 #include "Sandbox.h"
+#include "GpuSandbox.h"
+#include "BackendCheck.h"
+#include "Renderer.h"
 #include "FPS.h"
+#include "FrameScheduler.h"
+#include "SimulationThread.h"
 
+//Frames drawn per second at most, the simulation ticks at SIMULATION_HZ independently
 #define TARGET_FPS 100
+#define SIMULATION_HZ 100
+//Simulation steps a frame may run to catch up after a slow frame, the rest is dropped
+#define MAX_CATCH_UP_STEPS 4
+#define DEFAULT_CHECK_FRAMES 600
 
 void mouse_button_callback(GLFWwindow* window, int button, int action, double* xpos, double* ypos)
 {
@@ -32,37 +36,127 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, double* x
     }
 }
 
-void CheckCellType(GLFWwindow* window, Sandbox& sandbox) {
+void CheckCellType(GLFWwindow* window, SimulationInput& input) {
 
     if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS) {
-        sandbox.currentType = EMPTY;
+        input.type = EMPTY;
     }
     else if (glfwGetKey(window, GLFW_KEY_F) == GLFW_PRESS) {
-        sandbox.FillScreen();
+        input.fill = true;
     }
     else if (glfwGetKey(window, GLFW_KEY_1) == GLFW_PRESS) {
-        sandbox.currentType = SAND;
+        input.type = SAND;
     }
     else if (glfwGetKey(window, GLFW_KEY_2) == GLFW_PRESS) {
-        sandbox.currentType = WATER;
+        input.type = WATER;
     }
     else if (glfwGetKey(window, GLFW_KEY_3) == GLFW_PRESS) {
-        sandbox.currentType = WOOD;
+        input.type = WOOD;
     }
     else if (glfwGetKey(window, GLFW_KEY_4) == GLFW_PRESS) {
-        sandbox.currentType = STONE;
+        input.type = STONE;
     }
     else if (glfwGetKey(window, GLFW_KEY_5) == GLFW_PRESS) {
-        sandbox.currentType = LAVA;
+        input.type = LAVA;
     }
     else if (glfwGetKey(window, GLFW_KEY_6) == GLFW_PRESS) {
-        sandbox.currentType = FIRE;
+        input.type = FIRE;
     }
 }
 
-int main(void) {
+static void PrintUsage() {
+
+    std::cout << "Usage: \"OpenGL Cellular Automata\" [options]" << std::endl;
+    std::cout << "  --backend <name>    cpu = Sandbox, gpu = compute shaders, needs OpenGL 4.3 (default: cpu)" << std::endl;
+    std::cout << "  --verify            run the scenarios on both backends and compare cell counts and mean rows, no window" << std::endl;
+    std::cout << "  --scenario <name>   only verify this scenario" << std::endl;
+    std::cout << "  --frames <n>        frames per verified scenario (default: " << DEFAULT_CHECK_FRAMES << ")" << std::endl;
+    std::cout << "  --seed <n>          random seed (default: current time)" << std::endl;
+    std::cout << "  --single-thread     step the cpu backend on the render thread" << std::endl;
+    std::cout << "  --boundary <mode>   edges of the cpu backend: wall, wrap or sink (default: wall)" << std::endl;
+}
+
+//Runs the backend comparison in the current context, returns the process exit code
+static int VerifyBackends(const std::string& scenarioName, int frames) {
+
+    int failed = 0;
+
+    for (const Scenario& scenario : GetScenarios()) {
+
+        if (!scenarioName.empty() && scenario.name != scenarioName)
+            continue;
+
+        if (CheckBackends(scenario, frames, std::cout) == CHECK_FAILED)
+            failed++;
+    }
+
+    std::cout << (failed ? std::to_string(failed) + " scenario(s) differ" : std::string("Backends agree")) << std::endl;
+
+    return failed ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+
+    bool useGpu = false;
+    bool verify = false;
+    bool singleThread = false;
+    BoundaryMode boundary = BOUNDARY_WALL;
+    std::string scenarioName;
+    int frames = DEFAULT_CHECK_FRAMES;
+    uint64_t seed = (uint64_t)time(NULL);
+
+    for (int i = 1; i < argc; i++) {
+
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--backend" && hasValue) {
 
-    srand(time(NULL));
+            std::string backend = argv[++i];
+
+            if (backend != "cpu" && backend != "gpu") {
+
+                std::cout << "Unknown backend: " << backend << std::endl;
+                return 1;
+            }
+
+            useGpu = backend == "gpu";
+        }
+        else if (arg == "--verify") {
+            verify = true;
+        }
+        else if (arg == "--scenario" && hasValue) {
+            scenarioName = argv[++i];
+        }
+        else if (arg == "--frames" && hasValue) {
+            frames = std::atoi(argv[++i]);
+        }
+        else if (arg == "--seed" && hasValue) {
+            seed = std::strtoull(argv[++i], NULL, 10);
+        }
+        else if (arg == "--single-thread") {
+            singleThread = true;
+        }
+        else if (arg == "--boundary" && hasValue) {
+
+            std::string mode = argv[++i];
+
+            if (mode != "wall" && mode != "wrap" && mode != "sink") {
+
+                std::cout << "Unknown boundary: " << mode << std::endl;
+                return 1;
+            }
+
+            boundary = mode == "wrap" ? BOUNDARY_WRAP : (mode == "sink" ? BOUNDARY_SINK : BOUNDARY_WALL);
+        }
+        else {
+            PrintUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    //The verification compares seeded runs, the window only needs cheap numbers
+    SeedRandom(seed, verify ? RANDOM_COUNTER : RANDOM_FAST);
 
     GLFWwindow* window;
 
@@ -70,6 +164,16 @@ int main(void) {
     if (!glfwInit())
         return -1;
 
+    //Compute shaders need 4.3. The verification runs in a hidden window, Mesa's llvmpipe is enough
+    if (useGpu || verify) {
+
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    }
+
+    if (verify)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
     /* Create a windowed mode window and its OpenGL context */
     window = glfwCreateWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "window", NULL, NULL);
     if (!window)
@@ -90,112 +194,155 @@ int main(void) {
 
     //Print OpenGL version
     std::cout << "Version: " << glGetString(GL_VERSION) << std::endl;
-    {
-        FPS fps;
 
-        Sandbox sandbox;
+    if ((useGpu || verify) && !GpuSandbox::IsSupported()) {
+
+        std::cout << "The GPU backend needs OpenGL 4.3 compute shaders" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
 
-        unsigned int vao;
-        GLCall(glGenVertexArrays(1, &vao));
-        GLCall(glBindVertexArray(vao));
+    if (verify) {
 
-        VertexBuffer vb(sandbox.vertices, (sandbox.width + 1) * (sandbox.height + 1) * 2 * sizeof(int));
+        int result = VerifyBackends(scenarioName, frames);
 
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 2, GL_INT, GL_FALSE, sizeof(int) * 2, 0);
+        glfwTerminate();
+        return result;
+    }
 
-        IndexBuffer ib(sandbox.indices, sandbox.width * sandbox.height * 6);
+    {
+        FPS fps;
 
-        glm::mat4 projMat = glm::ortho(0.f, (float)SCREEN_WIDTH, 0.f, (float)SCREEN_HEIGHT, .0f, 1.f);
+        SimulationBackend* backend = useGpu ? (SimulationBackend*)new GpuSandbox() : new Sandbox();
+        SimulationBackend& sandbox = *backend;
 
-        Shader shader("VertFrag.shader");
-        shader.Bind();
+        //The GPU backend treats the outside as a wall
+        if (!useGpu)
+            ((Sandbox*)backend)->SetBoundary(boundary);
 
-        GLCall(glUniformMatrix4fv(shader.uMVPlocation, 1, GL_FALSE, &projMat[0][0]));
-        
-        GLCall(glBindVertexArray(0));
-        shader.Unbind();
-        vb.Unbind();
-        ib.Unbind();
+        Renderer renderer(sandbox);
 
-        //glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+        if (useGpu)
+            ((GpuSandbox*)backend)->SetLookBuffer(renderer.GetLookBuffer());
 
-        float r = 0.0f;
-        float increment = 0.05f;
+        //glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
-        /*GLCall(glUseProgram(shader));
+        FrameScheduler scheduler(1.0 / SIMULATION_HZ, 1.0 / TARGET_FPS, MAX_CATCH_UP_STEPS);
 
+        //Every step advances the physics by the same time, whatever the frame rate
+        sandbox.UpdateDeltaTime(scheduler.TickSeconds());
 
-        GLCall(glBindVertexArray(vao));
+        //The GPU backend needs the context, which belongs to this thread
+        SimulationThread* simulation = useGpu || singleThread ? nullptr : new SimulationThread(sandbox, scheduler.TickSeconds(), MAX_CATCH_UP_STEPS);
 
+        //Only read here from now on, the simulation thread owns the backend
+        Element currentType = sandbox.currentType;
 
-        ib.Bind();*/  
-        double lasttime = glfwGetTime();
-        double lastUpdateTime = 0;
+        //Where the brush was last frame, while the button stays down
+        bool drawing = false;
+        int lastX = 0, lastY = 0;
 
         /* Loop until the user closes the window */
         while (!glfwWindowShouldClose(window))
         {
+            int steps = scheduler.BeginFrame();
+
             /* Render here */
             glClear(GL_COLOR_BUFFER_BIT);
 
-            GLCall(glBindVertexArray(vao));
-            shader.Bind();
-            vb.Bind();
-            ib.Bind();
+            //Display FPS
+            fps.update();
+            int fps_num = fps.getFPS();
+            auto s_fps = std::to_string(fps_num);
+
+            //Look uploads of the previous frame
+            const UploadStats& uploads = renderer.GetUploadStats();
+            s_fps += " | uploads: " + std::to_string(uploads.calls) + " calls, " + std::to_string(uploads.bytes / 1024) + " KB";
+
+            //Where the frame time went over the last second, the simulation's own when it has a thread
+            const FrameTimes& times = simulation ? simulation->Frame().times : scheduler.GetFrameTimes();
+            std::ostringstream frameTimes;
+            frameTimes.precision(2);
+
+            if (simulation)
+                frameTimes << std::fixed << " | render idle " << scheduler.GetFrameTimes().idleMs << " ms, busy " << scheduler.GetFrameTimes().busyMs << " ms | simulation";
+
+            frameTimes << std::fixed << " | idle " << times.idleMs << " ms, busy " << times.busyMs << " ms, catch-up " << times.catchUpMs
+                << " ms, " << times.stepsPerFrame << " steps/frame, " << times.droppedSteps << " dropped";
+            s_fps += frameTimes.str();
+
+            glfwSetWindowTitle(window, s_fps.c_str());
+
 
-            double now = glfwGetTime();
-            double deltaTime = now - lastUpdateTime;
+            SimulationInput input = {};
+            input.type = currentType;
 
-            //Fps Limit
-            while (glfwGetTime() < lasttime + 1.0 / TARGET_FPS) {}
+            int state = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT);
+            if (state == GLFW_PRESS)
+            {
+                double xpos, ypos;
 
-            sandbox.UpdateDeltaTime(deltaTime);
+                mouse_button_callback(window, GLFW_MOUSE_BUTTON_LEFT, state, &xpos, &ypos);
 
-                //Display FPS
-                fps.update();
-                int fps_num = fps.getFPS();
-                auto s_fps = std::to_string(fps_num);
-                glfwSetWindowTitle(window, s_fps.c_str());
+                input.draw = true;
+                input.x = (int)xpos / TILE_SIZE;
+                input.y = (int)ypos / TILE_SIZE;
+                input.radius = 5;
 
+                input.stroke = drawing;
+                input.fromX = lastX;
+                input.fromY = lastY;
 
-                int state = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT);
-                if (state == GLFW_PRESS)
-                {
-                    double xpos, ypos;
+                lastX = input.x;
+                lastY = input.y;
+            }
 
-                    mouse_button_callback(window, GLFW_MOUSE_BUTTON_LEFT, state, &xpos, &ypos);
+            drawing = state == GLFW_PRESS;
 
-                    int x = (int)xpos / TILE_SIZE;
-                    int y = (int)ypos / TILE_SIZE;
+            CheckCellType(window, input);
 
-                    int index = (sandbox.width) * y + x;
+            if (simulation) {
 
-                    sandbox.DrawCircle(x, y, 5);
+                if (input.draw || input.fill || input.type != currentType)
+                    simulation->Submit(input);
+
+                int firstRow, lastRow;
+
+                if (simulation->AcquireFrame(firstRow, lastRow)) {
+
+                    renderer.UploadRows(simulation->Frame().looks.data(), firstRow, lastRow, simulation->Frame().time);
+                    renderer.UploadFlyingCells(simulation->Frame().flyingCells);
+                }
+            }
+            else {
+
+                ApplyInput(sandbox, input);
+
+                for (int step = 0; step < steps; step++) {
+
+                    sandbox.Update();
+                    scheduler.StepDone();
                 }
 
-                CheckCellType(window, sandbox);
+                renderer.UploadLooks();
+            }
 
-                sandbox.Update();
+            currentType = input.type;
 
-                sandbox.Draw();
+            renderer.Draw();
 
 
-                /* Swap front and back buffers */
-                glfwSwapBuffers(window);
+            /* Swap front and back buffers */
+            glfwSwapBuffers(window);
 
-                /* Poll for and process events */
-                glfwPollEvents();
-            
+            /* Poll for and process events */
+            glfwPollEvents();
 
-            lasttime += 1.0 / TARGET_FPS;
-            lastUpdateTime = now;
+            scheduler.EndFrame();
         }
 
-
-        GLCall(glBindVertexArray(0));
-        vb.Unbind();
-        ib.Unbind();
+        delete simulation;
+        delete backend;
     }
 
 
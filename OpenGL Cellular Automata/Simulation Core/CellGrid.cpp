@@ -0,0 +1,106 @@
+#include "CellGrid.h"
+#include <utility>
+#include <algorithm>
+
+CellGrid::CellGrid() {}
+
+CellGrid::~CellGrid() {
+
+	delete[] m_looks;
+	delete[] m_flags;
+	delete[] m_stamps;
+	delete[] m_velocities;
+	delete[] m_temperatures;
+	delete[] m_lives;
+}
+
+void CellGrid::Create(int count) {
+
+	m_count = count;
+
+	m_looks = new look_t[count];
+	m_flags = new uint8_t[count];
+	m_stamps = new uint16_t[count]();
+	m_velocities = new velocity_t[count];
+	m_temperatures = new float[count];
+	m_lives = new float[count];
+}
+
+void CellGrid::Set(int i, const cell_t& cell) {
+
+	m_looks[i] = MakeLook(cell.type, cell.shade);
+	m_flags[i] = (cell.isFalling ? CELL_FALLING : 0) | (cell.isBurning ? CELL_BURNING : 0);
+	SetMoved(i, cell.moved_last_frame);
+
+	m_velocities[i] = cell.velocity;
+	m_temperatures[i] = cell.temperature;
+	m_lives[i] = cell.life;
+}
+
+cell_t CellGrid::Get(int i) const {
+
+	cell_t cell = { Type(i) };
+
+	cell.isFalling = IsFalling(i);
+	cell.isBurning = IsBurning(i);
+	cell.moved_last_frame = HasMoved(i);
+
+	cell.velocity = m_velocities[i];
+	cell.temperature = m_temperatures[i];
+	cell.life = m_lives[i];
+	cell.shade = Shade(i);
+
+	return cell;
+}
+
+void CellGrid::Swap(int a, int b) {
+
+	std::swap(m_looks[a], m_looks[b]);
+	std::swap(m_flags[a], m_flags[b]);
+	std::swap(m_stamps[a], m_stamps[b]);
+	std::swap(m_velocities[a], m_velocities[b]);
+	std::swap(m_temperatures[a], m_temperatures[b]);
+	std::swap(m_lives[a], m_lives[b]);
+}
+
+void CellGrid::Copy(int from, int to) {
+
+	m_looks[to] = m_looks[from];
+	m_flags[to] = m_flags[from];
+	m_stamps[to] = m_stamps[from];
+	m_velocities[to] = m_velocities[from];
+	m_temperatures[to] = m_temperatures[from];
+	m_lives[to] = m_lives[from];
+}
+
+//One array of ShiftDown, the column is strided so it is swapped cell by cell
+template<typename T>
+static void SwapDown(T* values, int bottom, int count, int offset, int stride) {
+
+	for (int i = bottom, end = bottom + count * stride; i != end; i += stride)
+		std::swap(values[i], values[i - offset]);
+}
+
+void CellGrid::ShiftDown(int bottom, int count, int distance, int stride) {
+
+	const int offset = distance * stride;
+
+	SwapDown(m_looks, bottom, count, offset, stride);
+	SwapDown(m_flags, bottom, count, offset, stride);
+	SwapDown(m_stamps, bottom, count, offset, stride);
+	SwapDown(m_velocities, bottom, count, offset, stride);
+	SwapDown(m_temperatures, bottom, count, offset, stride);
+	SwapDown(m_lives, bottom, count, offset, stride);
+}
+
+void CellGrid::AdvanceFrame() {
+
+	m_frameStamp++;
+
+	//Once every 65535 frames the stamps wrap around, old stamps could then match again
+	if (m_frameStamp == 0) {
+
+		std::fill(m_stamps, m_stamps + m_count, 0);
+		m_frameStamp = 1;
+	}
+}
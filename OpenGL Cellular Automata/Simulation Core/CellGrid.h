@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Cells.h"
+#include <cstdint>
+
+#define CELL_FALLING 0x01
+#define CELL_BURNING 0x02
+//The high bits of the flags count the frames a cell could have moved but did not, up to CELL_IDLE_MAX
+#define CELL_IDLE_SHIFT 4
+#define CELL_IDLE_MASK 0xF0
+#define CELL_IDLE_MAX (CELL_IDLE_MASK >> CELL_IDLE_SHIFT)
+
+//The grid kept as one array per cell property. The movement rules mostly look at types and flags,
+//so those are packed into small words and scanned without pulling velocity, temperature and life along.
+//cell_t stays the value type for creating and copying single cells.
+//The type shares its word with the shade, that array is what the renderer uploads.
+class CellGrid {
+
+private:
+	int m_count = 0;
+
+	look_t* m_looks = nullptr;
+	uint8_t* m_flags = nullptr;
+
+	//A cell was updated this frame when its stamp equals m_frameStamp, so nothing has to be reset between frames
+	uint16_t* m_stamps = nullptr;
+	uint16_t m_frameStamp = 1;
+
+	velocity_t* m_velocities = nullptr;
+	float* m_temperatures = nullptr;
+	float* m_lives = nullptr;
+
+public:
+
+	CellGrid();
+	~CellGrid();
+
+	CellGrid(const CellGrid&) = delete;
+	CellGrid& operator=(const CellGrid&) = delete;
+
+	void Create(int count);
+	int Count() const { return m_count; }
+
+	inline Element Type(int i) const { return (Element)(m_looks[i] & 0xFF); }
+	inline void SetType(int i, Element type) { m_looks[i] = MakeLook(type, Shade(i)); }
+	inline uint8_t Shade(int i) const { return (uint8_t)(m_looks[i] >> 8); }
+	inline void SetShade(int i, uint8_t shade) { m_looks[i] = MakeLook(Type(i), shade); }
+	inline const look_t* Looks() const { return m_looks; }
+
+	inline velocity_t& Velocity(int i) { return m_velocities[i]; }
+	inline float& Temperature(int i) { return m_temperatures[i]; }
+	inline const float* Temperatures() const { return m_temperatures; }
+	inline float& Life(int i) { return m_lives[i]; }
+
+	inline bool HasFlag(int i, uint8_t flag) const { return (m_flags[i] & flag) != 0; }
+	inline void SetFlag(int i, uint8_t flag, bool value) { m_flags[i] = value ? (m_flags[i] | flag) : (m_flags[i] & ~flag); }
+
+	inline bool IsFalling(int i) const { return HasFlag(i, CELL_FALLING); }
+	inline void SetFalling(int i, bool value) { SetFlag(i, CELL_FALLING, value); }
+	inline bool IsBurning(int i) const { return HasFlag(i, CELL_BURNING); }
+	inline void SetBurning(int i, bool value) { SetFlag(i, CELL_BURNING, value); }
+	inline int Idle(int i) const { return m_flags[i] >> CELL_IDLE_SHIFT; }
+	inline void SetIdle(int i, int frames) { m_flags[i] = (uint8_t)((m_flags[i] & ~CELL_IDLE_MASK) | (frames << CELL_IDLE_SHIFT)); }
+	inline bool HasMoved(int i) const { return m_stamps[i] == m_frameStamp; }
+	inline void SetMoved(int i, bool value) { m_stamps[i] = value ? m_frameStamp : 0; }
+
+	//Starts a new frame, every cell counts as not moved afterwards
+	void AdvanceFrame();
+
+	void Set(int i, const cell_t& cell);
+	cell_t Get(int i) const;
+	void Swap(int a, int b);
+	//Cell to becomes a copy of cell from, stamp included
+	void Copy(int from, int to);
+	//Cells bottom, bottom + stride and so on, count of them, are each swapped with the cell distance rows below, from
+	//the bottom up. A falling column moves in one go, the cells it falls into come up above it
+	void ShiftDown(int bottom, int count, int distance, int stride);
+};
@@ -0,0 +1,82 @@
+#include "Cells.h"
+#include <array>
+
+float RandomFloat(float min, float max)
+{
+	return (RandomUnit() * (max - min)) + min;
+}
+
+uint8_t RandomShade() {
+
+	return (uint8_t)(RandomU32() % LOOK_SHADES);
+}
+
+//How a new cell of an element starts out. Ranges with min == max are constants and take no random draw, shaded
+//cells pick one of the LOOK_SHADES palette variants with a single draw
+typedef struct CellSpawn {
+
+	Element element;
+	bool shaded;
+	uint8_t shade;
+	float minTemperature, maxTemperature;
+	float minLife, maxLife;
+
+}CellSpawn;
+
+static constexpr CellSpawn SPAWN_ROWS[] = {
+
+	{ EMPTY, false, 0, 20.f, 20.f, 0.f, 0.f },
+	{ BORDER, false, 0, 0.f, 0.f, 0.f, 0.f },
+	{ SAND, true, 0, 30.f, 36.f, 2.f, 5.f },
+	{ WATER, true, 0, 10.f, 25.f, 10.f, 25.f },
+	{ WOOD, true, 0, 20.f, 22.f, 20.f, 30.f },
+	{ STONE, true, 0, 30.f, 36.f, 35.f, 50.f },
+	{ LAVA, true, 0, 1000.f, 1200.f, 15.f, 30.f },
+	//Hot looks are stamped by the backend that spawns them
+	{ FIRE, false, LOOK_HOT, 900.f, 1000.f, 15.f, 30.f },
+	{ SMOKE, false, LOOK_HOT, 26.f, 38.f, 15.f, 30.f }
+};
+
+//Indexed by Element, elements without a row of their own spawn empty cells
+static constexpr std::array<CellSpawn, NR_ELEMENTS> MakeSpawnTable() {
+
+	std::array<CellSpawn, NR_ELEMENTS> table = {};
+
+	for (CellSpawn& spawn : table)
+		spawn = SPAWN_ROWS[0];
+
+	for (const CellSpawn& row : SPAWN_ROWS)
+		table[row.element] = row;
+
+	return table;
+}
+
+static constexpr std::array<CellSpawn, NR_ELEMENTS> CELL_SPAWNS = MakeSpawnTable();
+
+static inline float SpawnRange(float min, float max) {
+
+	return min == max ? min : randomBetween(min, max);
+}
+
+cell_t cell_current(Element type) {
+
+	const CellSpawn& spawn = CELL_SPAWNS[type];
+
+	cell_t p = { spawn.element };
+
+	p.shade = spawn.shaded ? RandomShade() : spawn.shade;
+	p.temperature = SpawnRange(spawn.minTemperature, spawn.maxTemperature);
+	p.life = SpawnRange(spawn.minLife, spawn.maxLife);
+
+	return p;
+}
+
+cell_t cell_empty() { return cell_current(EMPTY); }
+cell_t cell_border() { return cell_current(BORDER); }
+cell_t cell_sand() { return cell_current(SAND); }
+cell_t cell_water() { return cell_current(WATER); }
+cell_t cell_wood() { return cell_current(WOOD); }
+cell_t cell_stone() { return cell_current(STONE); }
+cell_t cell_lava() { return cell_current(LAVA); }
+cell_t cell_fire() { return cell_current(FIRE); }
+cell_t cell_smoke() { return cell_current(SMOKE); }
\ No newline at end of file
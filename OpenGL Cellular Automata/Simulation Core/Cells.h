@@ -0,0 +1,80 @@
+#pragma once
+#include "Elements.h"
+#include <cstdint>
+
+//What the renderer gets for a cell, the element in the low byte and the shade byte in the high byte.
+//The palette in the fragment shader turns it into a color
+typedef uint16_t look_t;
+
+//Shade byte: which variation of the element's color the cell has, or with LOOK_HOT set the tick the cell
+//caught fire or spawned. Hot cells are animated by the shader from their age, so they are not written again
+//until LOOK_SPENT marks them as fully faded, before the stamp wraps around
+#define LOOK_HOT 0x80
+#define LOOK_SPENT 0x40
+#define LOOK_STAMP_MASK 0x3F
+#define LOOK_SHADES 0x80
+
+//Ticks of simulated time the hot looks are stamped and aged in, the stamp wraps after LOOK_AGE_TICKS
+#define LOOK_TICKS_PER_SECOND 16
+#define LOOK_AGE_TICKS (LOOK_STAMP_MASK + 1)
+#define LOOK_SPENT_AGE 48
+
+inline look_t MakeLook(Element type, uint8_t shade) { return (look_t)((uint8_t)type | (shade << 8)); }
+
+inline unsigned int LookTick(double time) { return (unsigned int)(time * LOOK_TICKS_PER_SECOND); }
+inline uint8_t HotShade(double time) { return (uint8_t)(LOOK_HOT | (LookTick(time) & LOOK_STAMP_MASK)); }
+inline unsigned int HotAge(uint8_t shade, double time) { return (LookTick(time) - shade) & LOOK_STAMP_MASK; }
+
+typedef struct velocity_t {
+
+	float x, y;
+}velocity_t;
+
+typedef struct cell_t {
+
+	Element type;
+
+	uint8_t shade;
+	velocity_t velocity;
+
+	//State properties
+	float temperature;
+	bool isBurning;
+	bool isFalling = true;
+	float life;
+	bool moved_last_frame;
+
+}cell_t;
+
+float RandomFloat(float min, float max);
+uint8_t RandomShade();
+
+cell_t cell_empty();
+cell_t cell_border();
+cell_t cell_sand();
+cell_t cell_water();
+cell_t cell_wood();
+cell_t cell_stone();
+cell_t cell_lava();
+cell_t cell_lavaStone();
+cell_t cell_ember();
+cell_t cell_fire();
+cell_t cell_ice();
+cell_t cell_ash();
+cell_t cell_magicDust();
+cell_t cell_smoke();
+cell_t cell_snow();
+cell_t cell_steam();
+cell_t cell_acid();
+cell_t cell_ceramic();
+cell_t cell_char();
+cell_t cell_seed();
+cell_t cell_leaf();
+cell_t cell_dirt();
+cell_t cell_luciferin();
+cell_t cell_lightning_start();
+cell_t cell_lightning();
+cell_t cell_gold();
+cell_t cell_jade();
+
+cell_t cell_current(Element type);
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include "Chunk.h"
+#include <climits>
+#include <bit>
+#include <algorithm>
+
+Chunk::Chunk()
+	: active(), nextActive(), nextReported(false), woken(), nextKept(), nextKeptAny(false)
+{
+}
+
+Chunk::~Chunk() {}
+
+Chunk::Chunk(vector_t topLeft, vector_t bottomRight)
+	: Chunk()
+{
+	this->topLeft = topLeft;
+	this->bottomRight = bottomRight;
+}
+
+void Chunk::setTopLeft(vector_t topLeft) {
+
+	this->topLeft = topLeft;
+}
+
+void Chunk::setTopRight(vector_t topRight) {
+
+	this->topRight = topRight;
+}
+
+void Chunk::setBottomRight(vector_t bottomRight) {
+
+	this->bottomRight = bottomRight;
+}
+void Chunk::setBottomLeft(vector_t bottomLeft) {
+
+	this->bottomLeft = bottomLeft;
+}
+
+void Chunk::markWhole() {
+
+	markNextCells(bottomLeft.x, bottomLeft.y, topRight.x, topRight.y);
+}
+
+void Chunk::markNextCells(int minX, int minY, int maxX, int maxY) {
+
+	markRows(nextActive, nextReported, minX, minY, maxX, maxY, bottomLeft);
+}
+
+void Chunk::keepNextCells(int minX, int minY, int maxX, int maxY) {
+
+	markRows(nextKept, nextKeptAny, minX, minY, maxX, maxY, bottomLeft);
+}
+
+void Chunk::addActiveCells(int minX, int maxX, int y) {
+
+	const uint32_t cells = (0xFFFFFFFFu >> (31 - (maxX - minX))) << (minX - bottomLeft.x);
+
+	//The rows of a chunk that was not updated are left from an earlier frame
+	if (!shouldUpdate) {
+
+		std::fill(active, active + CHUNK_MAX_CELLS, 0u);
+		activeCount = 0;
+		dirtyMin = { minX, y };
+		dirtyMax = { maxX, y };
+		shouldUpdate = true;
+	}
+
+	uint32_t& row = active[y - bottomLeft.y];
+
+	activeCount += std::popcount(cells & ~row);
+	row |= cells;
+
+	dirtyMin = { std::min(dirtyMin.x, minX), std::min(dirtyMin.y, y) };
+	dirtyMax = { std::max(dirtyMax.x, maxX), std::max(dirtyMax.y, y) };
+}
+
+void Chunk::markRows(std::atomic<uint32_t>* rows, std::atomic<bool>& any, int minX, int minY, int maxX, int maxY,
+	const vector_t& bottomLeft) {
+
+	const uint32_t cells = (0xFFFFFFFFu >> (31 - (maxX - minX))) << (minX - bottomLeft.x);
+
+	for (int y = minY; y <= maxY; y++) {
+
+		std::atomic<uint32_t>& row = rows[y - bottomLeft.y];
+
+		//Mostly the cells are set already, reading is cheaper than an atomic or
+		if ((row.load(std::memory_order_relaxed) & cells) != cells)
+			row.fetch_or(cells, std::memory_order_relaxed);
+	}
+
+	if (!any.load(std::memory_order_relaxed))
+		any.store(true, std::memory_order_relaxed);
+}
+
+void Chunk::shiftUpdatesAndReset() {
+
+	const int rows = topRight.y - bottomLeft.y + 1;
+
+	uint32_t columns = 0;
+	activeCount = 0;
+	shouldUpdate = false;
+
+	if (!nextReported.load(std::memory_order_relaxed) && !nextKeptAny.load(std::memory_order_relaxed))
+		return;
+
+	nextReported.store(false, std::memory_order_relaxed);
+	nextKeptAny.store(false, std::memory_order_relaxed);
+
+	dirtyMin = { INT_MAX, INT_MAX };
+	dirtyMax = { INT_MIN, INT_MIN };
+
+	//Nothing reports while the frame ends, so plain loads and stores are enough
+	for (int i = 0; i < rows; i++) {
+
+		woken[i] = nextActive[i].load(std::memory_order_relaxed);
+		active[i] = woken[i] | nextKept[i].load(std::memory_order_relaxed);
+
+		if (active[i] == 0)
+			continue;
+
+		nextActive[i].store(0, std::memory_order_relaxed);
+		nextKept[i].store(0, std::memory_order_relaxed);
+
+		columns |= active[i];
+		activeCount += std::popcount(active[i]);
+
+		dirtyMin.y = std::min(dirtyMin.y, bottomLeft.y + i);
+		dirtyMax.y = bottomLeft.y + i;
+	}
+
+	shouldUpdate = activeCount > 0;
+
+	if (shouldUpdate) {
+
+		dirtyMin.x = bottomLeft.x + std::countr_zero(columns);
+		dirtyMax.x = bottomLeft.x + 31 - std::countl_zero(columns);
+	}
+}
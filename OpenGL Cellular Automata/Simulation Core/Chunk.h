@@ -0,0 +1,67 @@
+#pragma once
+#include "Elements.h"
+#include <atomic>
+#include <cstdint>
+
+//Chunks are at most this many cells wide and high, a row of cells fits a 32-bit mask
+#define CHUNK_MAX_CELLS 32
+
+class Chunk {
+
+public:
+
+	Chunk();
+	Chunk(vector_t topLeft, vector_t bottomRight);
+	~Chunk();
+
+
+	bool shouldUpdate = true;
+
+	vector_t topLeft;
+	vector_t topRight;
+	vector_t bottomRight;
+	vector_t bottomLeft;
+
+	//Cells to update this frame, one bit per cell of every row: bit x - bottomLeft.x of row y - bottomLeft.y.
+	//Only valid while shouldUpdate is set
+	uint32_t active[CHUNK_MAX_CELLS];
+	int activeCount = 0;
+	//Bounding rectangle of the active cells, in cell coordinates and inclusive
+	vector_t dirtyMin;
+	vector_t dirtyMax;
+
+	//Cells touched this frame plus a one cell margin, become the active cells of the next frame.
+	//Neighbouring chunks of one parallel phase may report here at the same time, hence the atomics
+	std::atomic<uint32_t> nextActive[CHUNK_MAX_CELLS];
+	//Set once anything is in nextActive, idle chunks then end the frame without looking at their rows
+	std::atomic<bool> nextReported;
+
+	//The active cells that were reported by a change around them, the others only kept themselves awake
+	uint32_t woken[CHUNK_MAX_CELLS];
+	//Cells kept awake next frame without a change around them, their idle frames go on counting.
+	//Unsettled cells keep their neighbours too, which may lie in a chunk of another worker, hence the atomics
+	std::atomic<uint32_t> nextKept[CHUNK_MAX_CELLS];
+	std::atomic<bool> nextKeptAny;
+
+	void setTopLeft(vector_t topLeft);
+	void setBottomLeft(vector_t bottomLeft);
+	void setBottomRight(vector_t bottomRight);
+	void setTopRight(vector_t topRight);
+
+	void markWhole();
+	//Cells minX..maxX, minY..maxY are active next frame, the rectangle has to lie inside the chunk
+	void markNextCells(int minX, int minY, int maxX, int maxY);
+	//Cells minX..maxX, minY..maxY are kept active next frame without counting as woken, the rectangle has to lie
+	//inside the chunk
+	void keepNextCells(int minX, int minY, int maxX, int maxY);
+	//Cells minX..maxX of row y are active this frame as well, the walk picks them up if it has not passed the row yet.
+	//Only the thread updating the chunk may add cells
+	void addActiveCells(int minX, int maxX, int y);
+	inline bool isWoken(int x, int y) const { return (woken[y - bottomLeft.y] >> (x - bottomLeft.x)) & 1; }
+	void shiftUpdatesAndReset();
+
+private:
+
+	static void markRows(std::atomic<uint32_t>* rows, std::atomic<bool>& any, int minX, int minY, int maxX, int maxY,
+		const vector_t& bottomLeft);
+};
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Elements.h"
+#include <cstdint>
+
+//Which phases may move into a cell of the element, e.g. sand falls through smoke but not through water
+#define PASSABLE_BY_SOLID 0x01
+#define PASSABLE_BY_LIQUID 0x02
+#define PASSABLE_BY_GAS 0x04
+
+//The update rule family. Sandbox has one template specialization per kernel, the element's traits carry its parameters
+enum ElementKernel { KERNEL_NONE, KERNEL_POWDER, KERNEL_LIQUID, KERNEL_FUEL, KERNEL_GAS };
+
+typedef struct ElementTraits {
+
+	Element element;
+	Element_Type phase;
+	float density;
+	uint8_t passableBy;
+	bool flammable;
+	ElementKernel kernel;
+
+	//KERNEL_POWDER: chance a neighbour is not knocked loose
+	float inertialResistance;
+	//KERNEL_LIQUID: chance per frame to spawn fire above
+	float fireChance;
+	//KERNEL_FUEL: temperature from which the cell may catch fire
+	float ignitionTemperature;
+	//KERNEL_GAS: life lost per frame, chance to leave smoke behind, whether the color fades to red
+	float lifeDecay;
+	float smokeChance;
+	bool glows;
+
+}ElementTraits;
+
+//Indexed by Element, densities in kg/m^3
+inline constexpr ElementTraits ELEMENT_TRAITS[NR_ELEMENTS] = {
+
+	{ .element = EMPTY, .phase = VACUUM, .density = 0.f, .passableBy = PASSABLE_BY_SOLID | PASSABLE_BY_LIQUID | PASSABLE_BY_GAS },
+	{ .element = BORDER, .phase = SOLID, .density = 0.f },
+	{ .element = SAND, .phase = SOLID, .density = 1600.f, .kernel = KERNEL_POWDER, .inertialResistance = 0.1f },
+	{ .element = WATER, .phase = LIQUID, .density = 1000.f, .kernel = KERNEL_LIQUID },
+	{ .element = WOOD, .phase = SOLID, .density = 700.f, .flammable = true, .kernel = KERNEL_FUEL, .ignitionTemperature = 300.f },
+	{ .element = STONE, .phase = SOLID, .density = 2600.f },
+	{ .element = LAVA, .phase = LIQUID, .density = 3100.f, .kernel = KERNEL_LIQUID, .fireChance = 0.02f },
+	{ .element = LAVA_STONE, .phase = SOLID, .density = 2600.f },
+	{ .element = FIRE, .phase = GAS, .density = 0.3f, .kernel = KERNEL_GAS, .lifeDecay = 1.f, .smokeChance = 0.15f, .glows = true },
+	{ .element = EMBER, .phase = SOLID, .density = 800.f, .flammable = true },
+	{ .element = ICE, .phase = SOLID, .density = 917.f },
+	{ .element = ASH, .phase = SOLID, .density = 600.f },
+	{ .element = MAGIC_DUST, .phase = SOLID, .density = 500.f },
+	{ .element = SMOKE, .phase = GAS, .density = 0.6f, .passableBy = PASSABLE_BY_SOLID | PASSABLE_BY_LIQUID, .kernel = KERNEL_GAS, .lifeDecay = 0.05f },
+	{ .element = SNOW, .phase = SOLID, .density = 300.f },
+	{ .element = STEAM, .phase = GAS, .density = 0.6f, .passableBy = PASSABLE_BY_SOLID | PASSABLE_BY_LIQUID },
+	{ .element = ACID, .phase = LIQUID, .density = 1200.f },
+	{ .element = CERAMIC, .phase = SOLID, .density = 2300.f },
+	{ .element = CHAR, .phase = SOLID, .density = 400.f, .flammable = true },
+	{ .element = SEED, .phase = SOLID, .density = 900.f, .flammable = true },
+	{ .element = LEAF, .phase = SOLID, .density = 500.f, .flammable = true },
+	{ .element = DIRT, .phase = SOLID, .density = 1300.f },
+	{ .element = LUCIFERIN, .phase = LIQUID, .density = 1100.f },
+	{ .element = LIGHTNING_START, .phase = GAS, .density = 0.f },
+	{ .element = LIGHTNING, .phase = GAS, .density = 0.f },
+	{ .element = GOLD, .phase = SOLID, .density = 19300.f },
+	{ .element = MOLTEN_GOLD, .phase = LIQUID, .density = 17300.f },
+	{ .element = JADE, .phase = SOLID, .density = 3300.f }
+};
+
+constexpr bool TraitsInElementOrder() {
+
+	for (int i = 0; i < NR_ELEMENTS; i++) {
+
+		if (ELEMENT_TRAITS[i].element != i)
+			return false;
+	}
+
+	return true;
+}
+
+static_assert(TraitsInElementOrder(), "ELEMENT_TRAITS has to list every element in enum order");
+
+inline constexpr const ElementTraits& GetTraits(Element type) { return ELEMENT_TRAITS[type]; }
+
+inline constexpr uint32_t ElementBit(Element type) { return 1u << type; }
+
+//Elements whose passableBy has all the given bits, one bit per element
+constexpr uint32_t ElementsPassableBy(uint8_t phases) {
+
+	uint32_t mask = 0;
+
+	for (int i = 0; i < NR_ELEMENTS; i++) {
+
+		if ((ELEMENT_TRAITS[i].passableBy & phases) == phases)
+			mask |= ElementBit((Element)i);
+	}
+
+	return mask;
+}
+
+static_assert(NR_ELEMENTS <= 32, "Element masks are 32 bits wide");
+
+inline constexpr uint32_t SOLID_PASSABLE_MASK = ElementsPassableBy(PASSABLE_BY_SOLID);
+
+inline constexpr bool IsPassableBySolid(Element type) { return (ElementBit(type) & SOLID_PASSABLE_MASK) != 0; }
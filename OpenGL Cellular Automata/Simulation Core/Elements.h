@@ -1,25 +1,15 @@
 #pragma once
 
 #include <cstdlib>
-#include <unordered_map>
+#include "Random.h"
 
 enum Element{EMPTY, BORDER, SAND, WATER, WOOD, STONE, LAVA, LAVA_STONE, FIRE, EMBER, ICE, ASH, MAGIC_DUST,
 	SMOKE, SNOW, STEAM, ACID, CERAMIC, CHAR, SEED, LEAF, DIRT, LUCIFERIN, LIGHTNING_START, 
 	LIGHTNING, GOLD, MOLTEN_GOLD, JADE, NR_ELEMENTS
 };
 
-enum Element_Type { SOLID, LIQUID, GAS };
-
-static std::unordered_map < Element, Element_Type> Type_Map = {
-
-	{FIRE, GAS},
-	{STEAM, GAS},
-	{SMOKE, GAS},
-	{WATER, LIQUID},
-	{LAVA, LIQUID},
-	{MOLTEN_GOLD, LIQUID},
-	{LUCIFERIN, LIQUID}
-};
+//VACUUM is the phase of EMPTY
+enum Element_Type { SOLID, LIQUID, GAS, VACUUM };
 
 typedef struct color_t {
 
@@ -45,11 +35,11 @@ static color_t burn_col{ 255, 161, 38 };
 
 static float randomFloat()
 {
-	return (float)(rand()) / (float)(RAND_MAX);
+	return RandomUnit();
 }
 
 static const float randomBetween(float from, float to)
 {
 	float diff = to - from;
-	return (((float)rand() / RAND_MAX) * diff) + from;
+	return (RandomUnit() * diff) + from;
 }
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "HeatField.h"
+#include <algorithm>
+
+//Eight lanes with AVX2, four with SSE2 which every x64 build has, one cell at a time otherwise
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define HEAT_LANES 8
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HEAT_LANES 4
+#else
+#define HEAT_LANES 1
+#endif
+
+HeatField::HeatField() {}
+
+HeatField::~HeatField() {
+
+	delete[] m_gain;
+}
+
+void HeatField::Create(int width, int height) {
+
+	m_width = width;
+	m_height = height;
+	m_stride = width + 2;
+
+	m_gain = new float[m_stride * (height + 2)]();
+}
+
+void HeatField::Spread(const float* temperatures, int x1, int y1, int x2, int y2, float threshold, float rate) {
+
+	for (int y = y1; y <= y2; y++) {
+
+		const int row = m_stride * (y + 1) + 1;
+		const float* center = temperatures + row;
+		const float* below = center - m_stride;
+		const float* above = center + m_stride;
+		float* out = m_gain + row;
+		int x = x1;
+
+#if HEAT_LANES == 8
+		const __m256 limit = _mm256_set1_ps(threshold);
+		const __m256 r = _mm256_set1_ps(rate);
+
+		for (; x + 8 <= x2 + 1; x += 8) {
+
+			__m256 b = _mm256_loadu_ps(below + x);
+			__m256 a = _mm256_loadu_ps(above + x);
+			__m256 l = _mm256_loadu_ps(center + x - 1);
+			__m256 h = _mm256_loadu_ps(center + x + 1);
+
+			b = _mm256_and_ps(b, _mm256_cmp_ps(b, limit, _CMP_GT_OQ));
+			a = _mm256_and_ps(a, _mm256_cmp_ps(a, limit, _CMP_GT_OQ));
+			l = _mm256_and_ps(l, _mm256_cmp_ps(l, limit, _CMP_GT_OQ));
+			h = _mm256_and_ps(h, _mm256_cmp_ps(h, limit, _CMP_GT_OQ));
+
+			_mm256_storeu_ps(out + x, _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(b, a), _mm256_add_ps(l, h)), r));
+		}
+#elif HEAT_LANES == 4
+		const __m128 limit = _mm_set1_ps(threshold);
+		const __m128 r = _mm_set1_ps(rate);
+
+		for (; x + 4 <= x2 + 1; x += 4) {
+
+			__m128 b = _mm_loadu_ps(below + x);
+			__m128 a = _mm_loadu_ps(above + x);
+			__m128 l = _mm_loadu_ps(center + x - 1);
+			__m128 h = _mm_loadu_ps(center + x + 1);
+
+			b = _mm_and_ps(b, _mm_cmpgt_ps(b, limit));
+			a = _mm_and_ps(a, _mm_cmpgt_ps(a, limit));
+			l = _mm_and_ps(l, _mm_cmpgt_ps(l, limit));
+			h = _mm_and_ps(h, _mm_cmpgt_ps(h, limit));
+
+			_mm_storeu_ps(out + x, _mm_mul_ps(_mm_add_ps(_mm_add_ps(b, a), _mm_add_ps(l, h)), r));
+		}
+#endif
+
+		for (; x <= x2; x++) {
+
+			float b = below[x] > threshold ? below[x] : 0.f;
+			float a = above[x] > threshold ? above[x] : 0.f;
+			float l = center[x - 1] > threshold ? center[x - 1] : 0.f;
+			float h = center[x + 1] > threshold ? center[x + 1] : 0.f;
+
+			out[x] = ((b + a) + (l + h)) * rate;
+		}
+	}
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+//Heat every cell takes in from its four neighbours in one frame. It is computed in a stencil pass over the
+//temperatures at the start of the frame, so it does not depend on the order cells are updated in. Neighbours count
+//with their temperature when they are hotter than the threshold and with nothing otherwise. The gain has the layout
+//of the Sandbox's grid, with its boundary ring one cell wide around it, so the stencil needs no bounds checks and heat
+//crosses a wrapping boundary like the cells do
+class HeatField {
+
+private:
+	int m_width = 0;
+	int m_height = 0;
+	int m_stride = 0;
+
+	//(width + 2) x (height + 2), cell x, y is at m_stride * (y + 1) + x + 1
+	float* m_gain = nullptr;
+
+public:
+
+	HeatField();
+	~HeatField();
+
+	HeatField(const HeatField&) = delete;
+	HeatField& operator=(const HeatField&) = delete;
+
+	void Create(int width, int height);
+
+	//Gain of the cells x1..x2, y1..y2, rate times the sum of the neighbours above the threshold. The temperatures have
+	//the same layout, ring included
+	void Spread(const float* temperatures, int x1, int y1, int x2, int y2, float threshold, float rate);
+
+	//Index in the grid's layout
+	inline float Gain(int i) const { return m_gain[i]; }
+};
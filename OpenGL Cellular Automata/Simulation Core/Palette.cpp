@@ -0,0 +1,98 @@
+#include "Palette.h"
+#include "ElementTraits.h"
+#include "HSL.h"
+
+#include <algorithm>
+#include <cmath>
+
+uint32_t PackColor(const color_t& color) {
+
+	uint32_t r = (uint32_t)std::clamp(color.r, 0.f, 255.f);
+	uint32_t g = (uint32_t)std::clamp(color.g, 0.f, 255.f);
+	uint32_t b = (uint32_t)std::clamp(color.b, 0.f, 255.f);
+
+	return r | (g << 8) | (b << 16) | (255u << 24);
+}
+
+//Color every shade of the element is derived from, elements without one stay black like empty cells
+static color_t BaseColor(Element type) {
+
+	switch (type) {
+
+	case SAND:
+		return sand_col;
+	case WATER:
+		return water_col;
+	case WOOD:
+		return wood_col;
+	case STONE:
+		return stone_col;
+	case LAVA:
+		return lava_col;
+	case FIRE:
+		return fire_col;
+	case SMOKE:
+		return smoke_col;
+	default:
+		return empty_col;
+	}
+}
+
+//Up to 10 points darker and greyer, the low four bits of the shade step the luminance and the high three the saturation
+static color_t ShadeColor(color_t color, int shade) {
+
+	HSL hsl = TurnToHSL(color);
+
+	hsl.Hue = floor(hsl.Hue);
+	hsl.Luminance -= 10.0 * (shade & 15) / 15.0;
+	hsl.Saturation -= 10.0 * (shade >> 4) / 7.0;
+
+	return hsl.TurnToRGB();
+}
+
+//Glowing gases turn red and flicker, other gases thin out towards black, burning fuel smoulders from orange to dark red.
+//The colors approach their end exponentially, by rate per second
+static uint32_t HotColor(Element type, int age) {
+
+	const ElementTraits& traits = GetTraits(type);
+
+	color_t from = burn_col;
+	color_t to = { 148, 0, 0 };
+	float rate = 1.5f;
+	uint32_t flicker = 64;
+
+	if (traits.glows) {
+
+		from = BaseColor(type);
+		to = { 255, 0, 0 };
+		rate = 2.f;
+		flicker = 160;
+	}
+	else if (traits.phase == GAS) {
+
+		from = BaseColor(type);
+		to = { 12, 12, 12 };
+		rate = 0.5f;
+		flicker = 0;
+	}
+
+	float faded = 1.f - std::exp(-rate * age / LOOK_TICKS_PER_SECOND);
+	color_t color = { std::lerp(from.r, to.r, faded), std::lerp(from.g, to.g, faded), std::lerp(from.b, to.b, faded) };
+
+	return (PackColor(color) & 0x00FFFFFF) | (flicker << 24);
+}
+
+void BuildPalette(uint32_t* texels) {
+
+	for (int type = 0; type < NR_ELEMENTS; type++) {
+
+		color_t base = BaseColor((Element)type);
+		bool shaded = type != EMPTY && type != BORDER;
+
+		for (int shade = 0; shade < LOOK_SHADES; shade++) {
+
+			texels[PALETTE_WIDTH * type + shade] = PackColor(shaded ? ShadeColor(base, shade) : base);
+			texels[PALETTE_WIDTH * (NR_ELEMENTS + type) + shade] = HotColor((Element)type, std::min(shade, LOOK_SPENT_AGE));
+		}
+	}
+}
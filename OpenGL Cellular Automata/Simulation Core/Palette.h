@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Cells.h"
+#include <cstdint>
+
+//The renderer's palette texture. Row type holds the element's LOOK_SHADES shades, row NR_ELEMENTS + type
+//the colors of its hot cells by age in ticks, up to LOOK_SPENT_AGE. The alpha of a hot color is how much it flickers
+#define PALETTE_WIDTH LOOK_SHADES
+#define PALETTE_HEIGHT (NR_ELEMENTS * 2)
+
+//RGBA8 in memory order, r in the low byte. Alpha is always opaque
+uint32_t PackColor(const color_t& color);
+
+//Fills PALETTE_WIDTH * PALETTE_HEIGHT texels, row by row
+void BuildPalette(uint32_t* texels);
@@ -0,0 +1,130 @@
+#include "ParticleSystem.h"
+#include <algorithm>
+
+//Eight lanes with AVX, four with SSE which every x64 build has, one particle at a time otherwise
+#if defined(__AVX__)
+#include <immintrin.h>
+#define PARTICLE_LANES 8
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <xmmintrin.h>
+#define PARTICLE_LANES 4
+#else
+#define PARTICLE_LANES 1
+#endif
+
+void ParticleSystem::Add(float x, float y, const cell_t& cell) {
+
+	m_fromX.push_back(x);
+	m_fromY.push_back(y);
+	m_x.push_back(x + cell.velocity.x);
+	m_y.push_back(y - cell.velocity.y);
+	m_vx.push_back(cell.velocity.x);
+	m_vy.push_back(cell.velocity.y);
+	m_cells.push_back(cell);
+}
+
+void ParticleSystem::Replace(int i, float x, float y, const cell_t& cell) {
+
+	m_x[i] = x;
+	m_y[i] = y;
+	m_fromX[i] = x;
+	m_fromY[i] = y;
+	m_vx[i] = cell.velocity.x;
+	m_vy[i] = cell.velocity.y;
+	m_cells[i] = cell;
+}
+
+void ParticleSystem::Remove(int i) {
+
+	int last = Count() - 1;
+
+	m_x[i] = m_x[last];
+	m_y[i] = m_y[last];
+	m_fromX[i] = m_fromX[last];
+	m_fromY[i] = m_fromY[last];
+	m_vx[i] = m_vx[last];
+	m_vy[i] = m_vy[last];
+	m_cells[i] = m_cells[last];
+
+	m_x.pop_back();
+	m_y.pop_back();
+	m_fromX.pop_back();
+	m_fromY.pop_back();
+	m_vx.pop_back();
+	m_vy.pop_back();
+	m_cells.pop_back();
+}
+
+void ParticleSystem::Integrate(float fall, float maxFall, float drag) {
+
+	const int count = Count();
+	const float keep = 1.f - drag;
+
+	float* x = m_x.data();
+	float* y = m_y.data();
+	float* fromX = m_fromX.data();
+	float* fromY = m_fromY.data();
+	float* vx = m_vx.data();
+	float* vy = m_vy.data();
+	int i = 0;
+
+#if PARTICLE_LANES == 8
+	const __m256 f = _mm256_set1_ps(fall);
+	const __m256 limit = _mm256_set1_ps(maxFall);
+	const __m256 k = _mm256_set1_ps(keep);
+
+	for (; i + 8 <= count; i += 8) {
+
+		__m256 px = _mm256_loadu_ps(x + i);
+		__m256 py = _mm256_loadu_ps(y + i);
+		__m256 sx = _mm256_loadu_ps(vx + i);
+		__m256 sy = _mm256_min_ps(_mm256_add_ps(_mm256_loadu_ps(vy + i), f), limit);
+
+		_mm256_storeu_ps(fromX + i, px);
+		_mm256_storeu_ps(fromY + i, py);
+		_mm256_storeu_ps(x + i, _mm256_add_ps(px, sx));
+		_mm256_storeu_ps(y + i, _mm256_sub_ps(py, sy));
+		_mm256_storeu_ps(vx + i, _mm256_mul_ps(sx, k));
+		_mm256_storeu_ps(vy + i, sy);
+	}
+#elif PARTICLE_LANES == 4
+	const __m128 f = _mm_set1_ps(fall);
+	const __m128 limit = _mm_set1_ps(maxFall);
+	const __m128 k = _mm_set1_ps(keep);
+
+	for (; i + 4 <= count; i += 4) {
+
+		__m128 px = _mm_loadu_ps(x + i);
+		__m128 py = _mm_loadu_ps(y + i);
+		__m128 sx = _mm_loadu_ps(vx + i);
+		__m128 sy = _mm_min_ps(_mm_add_ps(_mm_loadu_ps(vy + i), f), limit);
+
+		_mm_storeu_ps(fromX + i, px);
+		_mm_storeu_ps(fromY + i, py);
+		_mm_storeu_ps(x + i, _mm_add_ps(px, sx));
+		_mm_storeu_ps(y + i, _mm_sub_ps(py, sy));
+		_mm_storeu_ps(vx + i, _mm_mul_ps(sx, k));
+		_mm_storeu_ps(vy + i, sy);
+	}
+#endif
+
+	for (; i < count; i++) {
+
+		float sy = std::min(vy[i] + fall, maxFall);
+
+		fromX[i] = x[i];
+		fromY[i] = y[i];
+		x[i] += vx[i];
+		y[i] -= sy;
+		vx[i] *= keep;
+		vy[i] = sy;
+	}
+}
+
+cell_t ParticleSystem::Cell(int i) const {
+
+	cell_t cell = m_cells[i];
+	cell.velocity = { m_vx[i], m_vy[i] };
+
+	return cell;
+}
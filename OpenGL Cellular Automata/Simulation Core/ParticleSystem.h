@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Cells.h"
+#include <vector>
+
+//Cells flying outside the grid, which Sandbox lifts out of it when they move fast and puts back where they hit
+//something. Positions are in cells and velocities in cells per frame, with y pointing up and the vertical velocity
+//pointing down like in the grid. Every property has its own array, so a frame of flight is integrated over all
+//particles several at a time
+class ParticleSystem {
+
+private:
+	std::vector<float> m_x;
+	std::vector<float> m_y;
+	//Where the particles were before they last moved, their path this frame starts there
+	std::vector<float> m_fromX;
+	std::vector<float> m_fromY;
+	std::vector<float> m_vx;
+	std::vector<float> m_vy;
+
+	//What each particle is, its velocity is kept in m_vx and m_vy while it flies
+	std::vector<cell_t> m_cells;
+
+public:
+
+	inline int Count() const { return (int)m_x.size(); }
+
+	//A cell at x, y that has gained this frame's speed already, it only moves by its velocity
+	void Add(float x, float y, const cell_t& cell);
+	//The last particle takes the place of particle i
+	void Remove(int i);
+
+	//Speeds every particle up by fall downwards, to maxFall at most, moves it and takes drag of its sideways speed
+	void Integrate(float fall, float maxFall, float drag);
+
+	inline float X(int i) const { return m_x[i]; }
+	inline float Y(int i) const { return m_y[i]; }
+	inline float FromX(int i) const { return m_fromX[i]; }
+	inline float FromY(int i) const { return m_fromY[i]; }
+	inline void SetPosition(int i, float x, float y) { m_x[i] = x; m_y[i] = y; }
+	//Particle i becomes the cell at x, y, which moves on from there by its own velocity next frame
+	void Replace(int i, float x, float y, const cell_t& cell);
+	inline Element Type(int i) const { return m_cells[i].type; }
+	inline look_t Look(int i) const { return MakeLook(m_cells[i].type, m_cells[i].shade); }
+
+	//The cell to put back into the grid, with the particle's velocity
+	cell_t Cell(int i) const;
+};
@@ -0,0 +1,88 @@
+#include "Random.h"
+#include "ThreadPool.h"
+
+#include <atomic>
+
+static uint64_t s_seed = 0;
+static RandomMode s_mode = RANDOM_FAST;
+static uint64_t s_frameKey = 0;
+
+//Bumped by SeedRandom so every thread re-seeds its fast generator on the next draw
+static std::atomic<unsigned int> s_generation(1);
+
+static thread_local uint64_t t_state = 0;
+static thread_local unsigned int t_generation = 0;
+
+static thread_local uint64_t t_cellKey = 0;
+static thread_local uint64_t t_draw = 0;
+
+//splitmix64 finalizer
+static inline uint64_t Mix(uint64_t z) {
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+void SeedRandom(uint64_t seed, RandomMode mode) {
+
+    s_seed = seed;
+    s_mode = mode;
+    s_frameKey = Mix(seed);
+
+    s_generation++;
+}
+
+uint64_t GetRandomSeed() {
+
+    return s_seed;
+}
+
+RandomMode GetRandomMode() {
+
+    return s_mode;
+}
+
+void SetRandomFrame(uint64_t frame) {
+
+    s_frameKey = Mix(s_seed + Mix(frame + 1));
+}
+
+void SetRandomCell(int x, int y, RandomStream stream) {
+
+    if (s_mode != RANDOM_COUNTER) return;
+
+    uint64_t cell = ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+
+    t_cellKey = Mix(s_frameKey ^ Mix(cell + ((uint64_t)stream << 62)));
+    t_draw = 0;
+}
+
+uint32_t RandomU32() {
+
+    if (s_mode == RANDOM_COUNTER) {
+
+        t_draw++;
+        return (uint32_t)(Mix(t_cellKey + t_draw * 0x9e3779b97f4a7c15ULL) >> 32);
+    }
+
+    if (t_generation != s_generation.load(std::memory_order_relaxed)) {
+
+        t_generation = s_generation.load(std::memory_order_relaxed);
+
+        //Never zero, that is the one state xorshift cannot leave
+        t_state = Mix(s_seed + ThreadPool::WorkerIndex() * 0x9e3779b97f4a7c15ULL) | 1;
+    }
+
+    //xorshift64*
+    t_state ^= t_state >> 12;
+    t_state ^= t_state << 25;
+    t_state ^= t_state >> 27;
+
+    return (uint32_t)((t_state * 0x2545f4914f6cdd1dULL) >> 32);
+}
+
+float RandomUnit() {
+
+    return (float)RandomU32() * (1.f / 4294967295.f);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+//RANDOM_FAST gives every thread its own xorshift generator, cheap but dependent on the order cells are updated in.
+//RANDOM_COUNTER hashes (seed, frame, cell, draw number) instead, so a cell gets the same numbers whatever the
+//update order or thread count is.
+enum RandomMode { RANDOM_FAST, RANDOM_COUNTER };
+
+//What the following draws are for, keeps the streams of a cell update, a row direction and a brush stroke apart
+enum RandomStream { RANDOM_STREAM_CELL, RANDOM_STREAM_ROW, RANDOM_STREAM_BRUSH };
+
+void SeedRandom(uint64_t seed, RandomMode mode);
+uint64_t GetRandomSeed();
+RandomMode GetRandomMode();
+
+//Called once per simulated frame, before any cell is updated
+void SetRandomFrame(uint64_t frame);
+
+//Keys the following draws of the calling thread to a cell. Only matters in RANDOM_COUNTER
+void SetRandomCell(int x, int y, RandomStream stream);
+
+uint32_t RandomU32();
+
+//Uniform in [0, 1]
+float RandomUnit();
+
+inline bool RandomBool() { return (RandomU32() & 1) != 0; }
@@ -0,0 +1,1431 @@
+#include "Sandbox.h"
+#include <cmath>
+#include <bit>
+#include <climits>
+
+#include <iostream>
+
+Sandbox::Sandbox()
+    : Sandbox(SCREEN_WIDTH / TILE_SIZE, SCREEN_HEIGHT / TILE_SIZE)
+{
+}
+
+//Cell a particle position is in
+static inline int CellOf(float position) { return (int)std::floor(position + 0.5f); }
+
+static_assert(SLEEP_FRAMES <= CELL_IDLE_MAX, "The idle frames of a cell are counted in its flags");
+static_assert(64 / TILE_SIZE <= CHUNK_MAX_CELLS, "A row of a chunk has to fit the active cell mask");
+
+Sandbox::Sandbox(int width, int height)
+{
+    this->width = width;
+    this->height = height;
+
+    numCellsPerChunk = 64 / TILE_SIZE;
+    chunkSize = numCellsPerChunk * TILE_SIZE;
+    chunk_width = (int)ceil((float)width / numCellsPerChunk);
+    chunk_height = (int)ceil((float)height / numCellsPerChunk);
+
+    CreateCells(width, height);
+    looks = m_cells.Looks() + Index(0, 0);
+    lookStride = m_stride;
+    CreateChunks();
+
+    maxDisplacement = numCellsPerChunk / 2 - 1;
+    workerSwaps.resize(1);
+    workerLifted.resize(1);
+    workerColumns.assign(1, -1);
+
+    currentType = STONE;
+}
+
+Sandbox::~Sandbox() {
+
+    delete[] chunks;
+    delete threadPool;
+}
+
+void Sandbox::CreateCells(int& width, int& height) {
+
+    m_stride = width + 2;
+
+    m_cells.Create(m_stride * (height + 2));
+    m_heat.Create(width, height);
+
+    for (int y = 0, i = 0; y < height; y++) {
+
+        for (int x = 0; x < width; x++) {
+
+            m_cells.Set(Index(x, y), cell_empty());
+        }
+    }
+
+    FillBoundary();
+}
+
+void Sandbox::FillBoundary() {
+
+    if (m_boundary == BOUNDARY_WRAP) {
+
+        //The columns first, the rows then carry them into the corners
+        for (int y = 0; y < height; y++) {
+
+            m_cells.Copy(Index(width - 1, y), Index(-1, y));
+            m_cells.Copy(Index(0, y), Index(width, y));
+        }
+
+        for (int x = -1; x <= width; x++) {
+
+            m_cells.Copy(Index(x, height - 1), Index(x, -1));
+            m_cells.Copy(Index(x, 0), Index(x, height));
+        }
+
+        return;
+    }
+
+    const cell_t cell = m_boundary == BOUNDARY_WALL ? cell_border() : cell_empty();
+
+    for (int x = -1; x <= width; x++) {
+
+        m_cells.Set(Index(x, -1), cell);
+        m_cells.Set(Index(x, height), cell);
+    }
+
+    for (int y = 0; y < height; y++) {
+
+        m_cells.Set(Index(-1, y), cell);
+        m_cells.Set(Index(width, y), cell);
+    }
+}
+
+void Sandbox::CreateChunks() {
+
+    chunks = new Chunk[chunk_width * chunk_height];
+
+    for (int y = 0; y < chunk_height; y++) {
+        for (int x = 0; x < chunk_width; x++) {
+
+            int index = y * chunk_width + x;
+
+            //Corners are in cell coordinates, the last row and column of chunks are clipped to the grid
+            int left = x * numCellsPerChunk;
+            int bottom = y * numCellsPerChunk;
+            int right = std::min(left + numCellsPerChunk - 1, width - 1);
+            int top = std::min(bottom + numCellsPerChunk - 1, height - 1);
+
+            chunks[index].setTopLeft({ left, top });
+            chunks[index].setTopRight({ right, top });
+            chunks[index].setBottomLeft({ left, bottom });
+            chunks[index].setBottomRight({ right, bottom });
+
+            //Everything is looked at once in the first frame
+            chunks[index].markWhole();
+            chunks[index].shiftUpdatesAndReset();
+        }
+    }
+}
+
+Chunk* Sandbox::GetChunkAtCellCoords(int x, int y) {
+
+    if (InBounds(x, y)) {
+
+        //Divide by numCellsPerChunk to get an index of the chunk - divide by numCellsPerChunk because thats how many cells the chunk has
+        return &chunks[chunk_width * (y / numCellsPerChunk) + (x / numCellsPerChunk)];
+    }
+
+    return NULL;
+}
+
+void Sandbox::ReportToChunk(int x, int y) {
+
+    if (!InBounds(x, y)) return;
+
+    ReportColumnToChunks(x, y, y, true);
+}
+
+void Sandbox::ReportColumnToChunks(int x, int y1, int y2, bool wakes) {
+
+    //The touched cells plus a one cell margin, which may spill over into the neighbouring chunks
+    ReportRectToChunks(x - 1, y1 - 1, x + 1, y2 + 1, wakes);
+
+    //Over a wrapping edge the margin goes on at the other side
+    if (m_boundary == BOUNDARY_WRAP) {
+
+        int wrappedX = x == 0 ? width - 1 : (x == width - 1 ? 0 : -1);
+        int wrappedY = y1 == 0 ? height - 1 : (y2 == height - 1 ? 0 : -1);
+
+        if (wrappedX >= 0)
+            ReportRectToChunks(wrappedX, y1 - 1, wrappedX, y2 + 1, wakes);
+        if (wrappedY >= 0)
+            ReportRectToChunks(x - 1, wrappedY, x + 1, wrappedY, wakes);
+        if (wrappedX >= 0 && wrappedY >= 0)
+            ReportRectToChunks(wrappedX, wrappedY, wrappedX, wrappedY, wakes);
+    }
+}
+
+void Sandbox::ReportRectToChunks(int minX, int minY, int maxX, int maxY, bool wakes) {
+
+    minX = std::max(minX, 0);
+    minY = std::max(minY, 0);
+    maxX = std::min(maxX, width - 1);
+    maxY = std::min(maxY, height - 1);
+
+    for (int cy = minY / numCellsPerChunk; cy <= maxY / numCellsPerChunk; cy++) {
+        for (int cx = minX / numCellsPerChunk; cx <= maxX / numCellsPerChunk; cx++) {
+
+            Chunk& chunk = chunks[chunk_width * cy + cx];
+
+            int chunkMinX = std::max(minX, chunk.bottomLeft.x);
+            int chunkMinY = std::max(minY, chunk.bottomLeft.y);
+            int chunkMaxX = std::min(maxX, chunk.topRight.x);
+            int chunkMaxY = std::min(maxY, chunk.topRight.y);
+
+            if (wakes)
+                chunk.markNextCells(chunkMinX, chunkMinY, chunkMaxX, chunkMaxY);
+            else
+                chunk.keepNextCells(chunkMinX, chunkMinY, chunkMaxX, chunkMaxY);
+        }
+    }
+}
+
+void Sandbox::KeepAwakeIfUnsettled(int x, int y, bool spreadsSideways) {
+
+    int cell = Index(x, y);
+
+    //Cells that moved were already reported by Swap
+    if (m_cells.HasMoved(cell)) return;
+
+    //Rules that only move with some probability may have left a free spot untried, look at the cell again next frame.
+    //Settled cells fall asleep right away, the others after SLEEP_FRAMES frames in which they kept still
+    bool unsettled = IsEmpty(x, y - 1) || IsEmpty(x - 1, y - 1) || IsEmpty(x + 1, y - 1);
+
+    if (spreadsSideways)
+        unsettled = unsettled || IsEmpty(x - 1, y) || IsEmpty(x + 1, y);
+
+    if (!unsettled) return;
+
+    //A change around the cell woke it up, it counts the frames from there
+    Chunk* chunk = GetChunkAtCellCoords(x, y);
+    int idle = chunk->isWoken(x, y) ? 0 : m_cells.Idle(cell);
+
+    if (idle >= SLEEP_FRAMES) return;
+
+    m_cells.SetIdle(cell, idle + 1);
+
+    //Its neighbours are looked at again too, one of them may move away before it next frame. Nothing changed around
+    //them, so their idle frames are not restarted
+    ReportColumnToChunks(x, y, y, false);
+}
+
+void Sandbox::WakeFollowers(int x, int y) {
+
+    int column = workerColumns[ThreadPool::WorkerIndex()];
+
+    if (column < 0) return;
+
+    //Nothing above the top row, a wrapping edge leads to the bottom row the walk has passed already
+    for (int row = y; row <= std::min(y + 1, height - 1); row++) {
+
+        Chunk* chunk = &chunks[chunk_width * (row / numCellsPerChunk) + column];
+
+        int minX = std::max(x - 1, chunk->bottomLeft.x);
+        int maxX = std::min(x + 1, chunk->topRight.x);
+
+        for (int i = minX; i <= maxX; i++) {
+
+            //Fuel takes in the heat spread before the update, only around the cells that were active then
+            if (GetTraits(m_cells.Type(Index(i, row))).kernel != KERNEL_FUEL)
+                chunk->addActiveCells(i, i, row);
+        }
+    }
+}
+
+void Sandbox::EndChunkFrame() {
+
+    for (int i = 0; i < chunk_width * chunk_height; i++)
+        chunks[i].shiftUpdatesAndReset();
+
+    m_cells.AdvanceFrame();
+}
+
+bool Sandbox::InBounds(int x, int y) const {
+
+    if (x >= 0 && x < width && y >= 0 && y < height) return 1;
+
+    return 0;
+}
+
+void Sandbox::ReportLookChange(int index) {
+
+    int worker = ThreadPool::WorkerIndex();
+
+    //Relative to looks, which starts at cell 0, 0
+    index -= m_stride + 1;
+
+    if (worker == 0)
+        changedCells.push_back(index);
+    else
+        workerChangedCells[worker - 1].push_back(index);
+}
+
+cell_t Sandbox::Spawn(Element type) {
+
+    cell_t cell = cell_current(type);
+
+    if (cell.shade & LOOK_HOT)
+        cell.shade = HotShade(time);
+
+    return cell;
+}
+
+void Sandbox::SettleHot(int index) {
+
+    uint8_t shade = m_cells.Shade(index);
+
+    if ((shade & (LOOK_HOT | LOOK_SPENT)) != LOOK_HOT || HotAge(shade, time) < LOOK_SPENT_AGE)
+        return;
+
+    m_cells.SetShade(index, shade | LOOK_SPENT);
+    ReportLookChange(index);
+}
+
+void Sandbox::PaintSpans(const CellSpan* spans, int count) {
+
+    bool sprayed = GetTraits(currentType).phase == GAS;
+
+    //The eraser clears flying cells too
+    if (currentType == EMPTY)
+        RemoveParticles(spans, count);
+
+    //Cells actually placed, the chunks around them are woken with one report
+    int minX = width, minY = height;
+    int maxX = -1, maxY = -1;
+
+    for (int i = 0; i < count; i++) {
+
+        const CellSpan& span = spans[i];
+
+        for (int x = span.x1; x <= span.x2; x++) {
+
+            int index = Index(x, span.y);
+
+            SetRandomCell(x, span.y, RANDOM_STREAM_BRUSH);
+
+            //Gases are sprayed into about every fifth cell
+            if (sprayed && RandomFloat(0.f, 1.f) < 0.8f)
+                continue;
+
+            //The eraser clears anything, other elements only go into empty cells
+            if (currentType != EMPTY && m_cells.Type(index) != EMPTY)
+                continue;
+
+            m_cells.Set(index, Spawn(currentType));
+            ReportLookChange(index);
+
+            if (currentType != EMPTY)
+                m_cells.Velocity(index).x = RandomBool() ? 1.f : -1.f;
+
+            minX = std::min(minX, x);
+            maxX = std::max(maxX, x);
+            minY = std::min(minY, span.y);
+            maxY = std::max(maxY, span.y);
+        }
+    }
+
+    if (minX <= maxX)
+        ReportRectToChunks(minX - 1, minY - 1, maxX + 1, maxY + 1, true);
+}
+
+void Sandbox::FillSpans(const CellSpan* spans, int count, Element type) {
+
+    //A region clipped away entirely has no rows to report
+    if (count <= 0)
+        return;
+
+    RemoveParticles(spans, count);
+
+    std::function<void(int)> fillSpan = [&](int i) {
+
+        const CellSpan& span = spans[i];
+
+        for (int x = span.x1; x <= span.x2; x++) {
+
+            SetRandomCell(x, span.y, RANDOM_STREAM_BRUSH);
+            m_cells.Set(Index(x, span.y), Spawn(type));
+        }
+    };
+
+    //Spans never share cells, so they are spread over the pool
+    if (threadPool != NULL && count > 1)
+        threadPool->ParallelFor(count, fillSpan);
+    else {
+
+        for (int i = 0; i < count; i++)
+            fillSpan(i);
+    }
+
+    int minX = width;
+    int maxX = -1;
+
+    for (int i = 0; i < count; i++) {
+
+        minX = std::min(minX, spans[i].x1);
+        maxX = std::max(maxX, spans[i].x2);
+    }
+
+    //Rows are uploaded whole and the chunks woken once, instead of cell by cell
+    ReportRowsChanged(spans[0].y, spans[count - 1].y);
+    ReportRectToChunks(minX - 1, spans[0].y - 1, maxX + 1, spans[count - 1].y + 1, true);
+}
+
+ElementCensus Sandbox::TakeCensus() {
+
+    ElementCensus census = {};
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+
+            Element type = m_cells.Type(Index(x, y));
+
+            census.count[type]++;
+            census.heightSum[type] += y;
+        }
+    }
+
+    for (int i = 0; i < m_particles.Count(); i++) {
+
+        census.count[m_particles.Type(i)]++;
+        census.heightSum[m_particles.Type(i)] += CellOf(m_particles.Y(i));
+    }
+
+    return census;
+}
+
+void Sandbox::Swap(int x1, int y1, int x2, int y2) {
+
+    if (!InBounds(x2, y2)) {
+
+        SwapOut(x1, y1, x2, y2);
+        return;
+    }
+
+    int a = Index(x1, y1);
+    int b = Index(x2, y2);
+
+    m_cells.Swap(a, b);
+    workerSwaps[ThreadPool::WorkerIndex()].count++;
+
+    m_cells.SetMoved(a, true);
+    m_cells.SetMoved(b, true);
+
+    ReportLookChange(a);
+    ReportLookChange(b);
+
+    ReportToChunk(x1, y1);
+    ReportToChunk(x2, y2);
+
+    WakeFollowers(x1, y1);
+}
+
+void Sandbox::SwapOut(int x1, int y1, int x2, int y2) {
+
+    //Walls are never empty and nothing moves into them, so this is a sink or a wrapping edge
+    if (m_boundary == BOUNDARY_SINK) {
+
+        m_cells.Set(Index(x1, y1), cell_empty());
+        m_cells.SetMoved(Index(x1, y1), true);
+        ReportLookChange(Index(x1, y1));
+        ReportToChunk(x1, y1);
+        WakeFollowers(x1, y1);
+        return;
+    }
+
+    x2 = (x2 + width) % width;
+    y2 = (y2 + height) % height;
+
+    //The ring is copied at the start of the frame, the cell it showed may have been filled since
+    if (IsEmpty(x2, y2))
+        Swap(x1, y1, x2, y2);
+}
+
+void Sandbox::Replace(int x, int y, Element type) {
+
+    if (!InBounds(x, y)) return;
+
+    m_cells.Set(Index(x, y), Spawn(type));
+    ReportLookChange(Index(x, y));
+    ReportToChunk(x, y);
+}
+
+void Sandbox::CheckCell(int cell, int &x, int& y) {
+
+    if (m_cells.HasMoved(cell)) return;
+
+    Element type = m_cells.Type(cell);
+
+    if (GetTraits(type).kernel == KERNEL_NONE) return;
+
+    SetRandomCell(x, y, RANDOM_STREAM_CELL);
+
+    (this->*s_updateKernels[type])(x, y, GetTraits(type));
+}
+
+void Sandbox::UpdateCellsInChunk(Chunk* chunk) { ///WORKS but I have to reconstruct applying hit to not receive but give
+
+    //Only the active cells, row by row and in the order of the row's direction
+    for (int y = chunk->dirtyMin.y; y <= chunk->dirtyMax.y; y++) {
+
+        const uint32_t& active = chunk->active[y - chunk->bottomLeft.y];
+        uint32_t cells = active;
+
+        if (cells == 0) continue;
+
+        //Fix rendering bias
+        SetRandomCell(chunk->bottomLeft.x, y, RANDOM_STREAM_ROW);
+        const bool leftToRight = RandomBool();
+        const int left = chunk->bottomLeft.x;
+        const int row = Index(0, y);
+
+        //The row is read again after every cell, a cell that moved away may have woken the ones still ahead
+        if (leftToRight) {
+
+            while (cells != 0) {
+
+                int bit = std::countr_zero(cells);
+                int x = left + bit;
+                CheckCell(row + x, x, y);
+
+                cells = bit == 31 ? 0 : active & (0xFFFFFFFFu << (bit + 1));
+            }
+        }
+        else {
+            while (cells != 0) {
+
+                int bit = 31 - std::countl_zero(cells);
+                int x = left + bit;
+                CheckCell(row + x, x, y);
+
+                cells = active & ((1u << bit) - 1);
+            }
+        }
+    }
+}
+
+void Sandbox::UpdateChunks() {
+
+    std::vector<int> phaseColumns;
+
+    //A column of chunks is updated bottom up by one worker, so cells fall through the chunk borders in the same order
+    //as inside a chunk
+    std::function<void(int)> task = [this, &phaseColumns](int i) {
+
+        int& column = workerColumns[ThreadPool::WorkerIndex()];
+        column = phaseColumns[i];
+
+        for (int y = 0; y < chunk_height; y++) {
+
+            Chunk* chunk = &chunks[chunk_width * y + column];
+
+            if (chunk->shouldUpdate)
+                UpdateCellsInChunk(chunk);
+        }
+
+        column = -1;
+    };
+
+    //With an odd number of columns the first and last ones are in the same phase, and next to each other when the
+    //boundary wraps
+    const bool parallel = threadPool != NULL && !(m_boundary == BOUNDARY_WRAP && chunk_width % 2 != 0);
+
+    //Columns of one phase are a whole chunk apart, so with maxDisplacement below half a chunk they never share cells.
+    //Without a pool the phases run inline in the same order, so a seeded run ends the same for any thread count
+    for (int phase = 0; phase < 2; phase++) {
+
+        phaseColumns.clear();
+
+        for (int x = phase; x < chunk_width; x += 2) {
+
+            for (int y = 0; y < chunk_height; y++) {
+
+                if (chunks[chunk_width * y + x].shouldUpdate) {
+
+                    phaseColumns.push_back(x);
+                    break;
+                }
+            }
+        }
+
+        if (parallel) {
+
+            threadPool->ParallelFor((int)phaseColumns.size(), task);
+        }
+        else {
+
+            for (int i = 0; i < (int)phaseColumns.size(); i++)
+                task(i);
+        }
+    }
+
+    for (std::vector<int>& changed : workerChangedCells) {
+
+        changedCells.insert(changedCells.end(), changed.begin(), changed.end());
+        changed.clear();
+    }
+}
+
+void Sandbox::SetThreadCount(int threadCount) {
+
+    delete threadPool;
+    threadPool = NULL;
+    workerChangedCells.clear();
+    workerSwaps.assign(std::max(threadCount, 1), SwapCounter());
+    workerLifted.assign(std::max(threadCount, 1), std::vector<LiftedCell>());
+    workerColumns.assign(std::max(threadCount, 1), -1);
+
+    this->threadCount = std::max(threadCount, 0);
+
+    if (threadCount > 1) {
+
+        threadPool = new ThreadPool(threadCount);
+        workerChangedCells.resize(threadCount - 1);
+    }
+}
+
+int Sandbox::GetThreadCount() const {
+
+    return threadCount;
+}
+
+void Sandbox::SetBoundary(BoundaryMode boundary) {
+
+    m_boundary = boundary;
+    FillBoundary();
+
+    //Cells along the edges may move now
+    ReportRectToChunks(0, 0, width - 1, height - 1, true);
+}
+
+BoundaryMode Sandbox::GetBoundary() const {
+
+    return m_boundary;
+}
+
+void Sandbox::Update() {
+
+    SetRandomFrame(frameCount++);
+
+    if (m_boundary == BOUNDARY_WRAP)
+        FillBoundary();
+
+    SpreadHeat();
+
+    UpdateChunks();
+
+    //Counted after the update, which may add cells that were left by the cells below them
+    lastUpdatedCells = 0;
+
+    for (int i = 0; i < chunk_width * chunk_height; i++) {
+
+        if (chunks[i].shouldUpdate)
+            lastUpdatedCells += chunks[i].activeCount;
+    }
+
+    MoveParticles();
+
+    EndChunkFrame();
+
+    time += dt;
+
+    lastSwapCount = 0;
+
+    for (SwapCounter& swaps : workerSwaps) {
+
+        lastSwapCount += swaps.count;
+        swaps.count = 0;
+    }
+}
+
+void Sandbox::SetSurroundingFalling(int x, int y, float& inertialResistance) {
+
+    //Cells that fell into the ring have no neighbours to set
+    if (!InBounds(x, y)) return;
+
+    int cell = Index(x, y);
+
+    if (randomFloat() > inertialResistance) {
+        m_cells.SetFalling(cell - m_stride, true);
+    }
+    if (randomFloat() > inertialResistance) {
+        m_cells.SetFalling(cell - 1, true);
+    }
+    if (randomFloat() > inertialResistance) {
+        m_cells.SetFalling(cell + 1, true);
+    }
+
+    //reportToChunk(x, y);
+}
+
+void Sandbox::SpreadHeat() {
+
+    //Only active cells read their gain. A band of one chunk row is spread over the rectangle around its updated chunks,
+    //so the pass runs over long rows and the bands never write the same cells
+    struct HeatBand { vector_t min, max; };
+    std::vector<HeatBand> bands;
+
+    for (int y = 0; y < chunk_height; y++) {
+
+        HeatBand band = { { INT_MAX, INT_MAX }, { INT_MIN, INT_MIN } };
+
+        for (int x = 0; x < chunk_width; x++) {
+
+            const Chunk& chunk = chunks[chunk_width * y + x];
+
+            if (!chunk.shouldUpdate) continue;
+
+            band.min = { std::min(band.min.x, chunk.dirtyMin.x), std::min(band.min.y, chunk.dirtyMin.y) };
+            band.max = { std::max(band.max.x, chunk.dirtyMax.x), std::max(band.max.y, chunk.dirtyMax.y) };
+        }
+
+        if (band.min.x <= band.max.x)
+            bands.push_back(band);
+    }
+
+    const float* temperatures = m_cells.Temperatures();
+    const float rate = HEAT_ABSORB_RATE * (float)dt;
+
+    std::function<void(int)> spread = [&](int i) {
+
+        const HeatBand& band = bands[i];
+        m_heat.Spread(temperatures, band.min.x, band.min.y, band.max.x, band.max.y, HEAT_SOURCE_TEMPERATURE, rate);
+    };
+
+    if (threadPool != NULL) {
+
+        threadPool->ParallelFor((int)bands.size(), spread);
+    }
+    else {
+
+        for (int i = 0; i < (int)bands.size(); i++)
+            spread(i);
+    }
+}
+
+void Sandbox::Lift(int x, int y) {
+
+    int cell = Index(x, y);
+
+    workerLifted[ThreadPool::WorkerIndex()].push_back({ cell, x, y, m_cells.Get(cell) });
+
+    m_cells.Set(cell, cell_empty());
+    m_cells.SetMoved(cell, true);
+    ReportLookChange(cell);
+    ReportToChunk(x, y);
+}
+
+void Sandbox::MoveParticles() {
+
+    m_particles.Integrate(2.f * gravity * (float)dt, PARTICLE_MAX_FALL, PARTICLE_DRAG);
+
+    //Workers lift cells in whatever order they get to the chunks, sorted they join in the same order every run
+    std::vector<LiftedCell>& lifted = workerLifted[0];
+
+    for (size_t worker = 1; worker < workerLifted.size(); worker++) {
+
+        lifted.insert(lifted.end(), workerLifted[worker].begin(), workerLifted[worker].end());
+        workerLifted[worker].clear();
+    }
+
+    std::sort(lifted.begin(), lifted.end(), [](const LiftedCell& a, const LiftedCell& b) { return a.index < b.index; });
+
+    for (const LiftedCell& cell : lifted)
+        m_particles.Add((float)cell.x, (float)cell.y, cell.cell);
+
+    lifted.clear();
+
+    //One after the other, a particle that landed is in the way of the next ones
+    for (int i = 0; i < m_particles.Count();) {
+
+        if (FlyParticle(i))
+            i++;
+        else
+            m_particles.Remove(i);
+    }
+
+    flyingCells.clear();
+
+    for (int i = 0; i < m_particles.Count(); i++)
+        flyingCells.push_back({ m_particles.X(i), m_particles.Y(i), m_particles.Look(i) });
+}
+
+bool Sandbox::FlyParticle(int i) {
+
+    float x = m_particles.FromX(i);
+    float y = m_particles.FromY(i);
+
+    const float dx = m_particles.X(i) - x;
+    const float dy = m_particles.Y(i) - y;
+    const int steps = std::max(1, (int)std::ceil(std::max(std::abs(dx), std::abs(dy))));
+
+    //The cell it was in may have been taken since, by the grid or a particle that landed
+    int lastX = CellOf(x);
+    int lastY = CellOf(y);
+    bool free = IsEmpty(lastX, lastY);
+    bool hit = false;
+
+    //At most one cell on either axis per step
+    for (int step = 0; step < steps && !hit; step++) {
+
+        x += dx / steps;
+        y += dy / steps;
+
+        int cellX = CellOf(x);
+        int cellY = CellOf(y);
+
+        if (cellX == lastX && cellY == lastY)
+            continue;
+
+        if (!InBounds(cellX, cellY)) {
+
+            if (m_boundary == BOUNDARY_SINK)
+                return false;
+
+            if (m_boundary == BOUNDARY_WALL) {
+
+                hit = true;
+                continue;
+            }
+
+            //Comes in at the other side
+            float shiftX = cellX < 0 ? (float)width : (cellX >= width ? (float)-width : 0.f);
+            float shiftY = cellY < 0 ? (float)height : (cellY >= height ? (float)-height : 0.f);
+
+            x += shiftX;
+            y += shiftY;
+            cellX = CellOf(x);
+            cellY = CellOf(y);
+            m_particles.SetPosition(i, m_particles.X(i) + shiftX, m_particles.Y(i) + shiftY);
+        }
+
+        if (!IsEmpty(cellX, cellY)) {
+
+            hit = true;
+            continue;
+        }
+
+        lastX = cellX;
+        lastY = cellY;
+        free = true;
+    }
+
+    if (!hit)
+        return true;
+
+    //Nowhere free on its way, another cell or particle took the one it came from
+    if (!free)
+        free = FindLanding(lastX, lastY);
+
+    int cell = Index(lastX, lastY);
+    cell_t taken = m_cells.Get(cell);
+
+    m_cells.Set(cell, m_particles.Cell(i));
+    ReportLookChange(cell);
+    ReportToChunk(lastX, lastY);
+
+    if (free)
+        return false;
+
+    //Not a single empty cell in the grid, the cell it came from flies on in its place
+    m_particles.Replace(i, (float)lastX, (float)lastY, taken);
+
+    return true;
+}
+
+bool Sandbox::FindLanding(int& x, int& y) const {
+
+    const int maxRange = std::max(width, height);
+
+    for (int range = 1; range <= maxRange; range++) {
+
+        for (int dy = range; dy >= -range; dy--) {
+
+            //Only the ring at this range, the inner ones were searched already
+            int step = std::abs(dy) == range ? 1 : 2 * range;
+
+            for (int dx = -range; dx <= range; dx += step) {
+
+                int cellX = x + dx;
+                int cellY = y + dy;
+
+                if (m_boundary == BOUNDARY_WRAP) {
+
+                    cellX = (cellX % width + width) % width;
+                    cellY = (cellY % height + height) % height;
+                }
+
+                if (InBounds(cellX, cellY) && IsEmpty(cellX, cellY)) {
+
+                    x = cellX;
+                    y = cellY;
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+void Sandbox::RemoveParticles(const CellSpan* spans, int count) {
+
+    for (int i = 0; i < m_particles.Count();) {
+
+        int x = CellOf(m_particles.X(i));
+        int y = CellOf(m_particles.Y(i));
+
+        //The spans are ordered by row
+        const CellSpan* span = std::lower_bound(spans, spans + count, y, [](const CellSpan& span, int y) { return span.y < y; });
+        bool inside = false;
+
+        for (; span != spans + count && span->y == y && !inside; span++)
+            inside = x >= span->x1 && x <= span->x2;
+
+        if (inside)
+            m_particles.Remove(i);
+        else
+            i++;
+    }
+}
+
+void Sandbox::Ignite(int& x, int& y) {
+
+    int cell = Index(x, y);
+
+    if (!m_cells.IsBurning(cell)) {
+
+        m_cells.SetShade(cell, HotShade(time));
+        ReportLookChange(cell);
+        m_cells.Temperature(cell) += 300.f;
+
+        m_cells.SetBurning(cell, true);
+        ReportToChunk(x, y);
+    }
+}
+
+void Sandbox::Burn(int& x, int& y) {
+
+    int cell = Index(x, y);
+
+    if (m_cells.IsBurning(cell)) {
+
+        m_cells.Temperature(cell) -= (int)(m_cells.Temperature(cell) / 4.5f) % 4 + 4.5f;
+
+        SettleHot(cell);
+        ReportToChunk(x, y);
+
+        if (IsEmpty(x, y + 1)) {
+
+            if (RandomFloat(0.f, 1.f) >= 0.9f)
+                Replace(x, y + 1, FIRE);
+        }
+
+        if (m_cells.Temperature(cell) <= 300.f) {
+
+            /*If next to water, extinguish
+            if (cells[x][y - 1].type == WATER || cells[x][y + 1].type == WATER || cells[x - 1][y].type == WATER || cells[x + 1][y].type == WATER) {
+                replace(x, y, CHAR);
+            }
+            else {
+                if (randomChance(50, 1) < 2)
+                    replace(x, y, ASH);
+                else if (randomChance(50, 1) >= 3 && randomChance(50, 1) < 5) {
+                    replace(x, y, SMOKE);
+                }
+            }*/
+
+            if (RandomFloat(0.f, 1.f) >= 0.8f)
+                Replace(x, y, SMOKE);
+            else
+                Replace(x, y, EMPTY);
+
+
+            m_cells.SetBurning(cell, false);
+        }
+    }
+}
+
+void Sandbox::UpdateDeltaTime(double dt) {
+
+    this->dt = dt;
+}
+
+float Sandbox::UpdateVelocity(int x, int y) {
+
+    //reportToChunk(x, y);
+
+    int cell = Index(x, y);
+
+    //GRAVITY - FINALLY WORKING
+    m_cells.Velocity(cell).y = std::clamp(m_cells.Velocity(cell).y + (gravity * (float)this->dt), -10.f, 50.f);
+
+    m_cells.Velocity(cell).y += gravity * (float)this->dt;
+    if (!IsPassableBySolid(m_cells.Type(cell - m_stride)))
+        m_cells.Velocity(cell).y /= 1.25f;
+
+    return m_cells.Velocity(cell).y;
+}
+
+void Sandbox::MovingSolid(int& x, int& y, int cell, float inertialResistance) {
+
+    //How far the cell fell straight down this frame and its velocity before, for the cells behind it
+    int fell = 0;
+    velocity_t fallingFrom = {};
+
+    //If is landing transfer some of y velocity to x velocity and reduce y velocity
+    if ((!IsEmpty(x, y - 1)) && m_cells.IsFalling(cell)) {
+        m_cells.Velocity(cell).x = RandomFloat(-1.f, 1.f);
+        m_cells.Velocity(cell).y /= 2.f;
+    }
+
+    if (m_cells.Velocity(cell).x < -2.f) {
+        m_cells.Velocity(cell).x = -2.f;
+    }
+    if (m_cells.Velocity(cell).x > 2.f) {
+        m_cells.Velocity(cell).x = 2.f;
+    }
+
+    if (!m_cells.IsFalling(cell)) {
+
+        m_cells.Velocity(cell).y = 0;
+
+        if (std::abs(m_cells.Velocity(cell).x) < 0.1f)
+            m_cells.Velocity(cell).x = 0;
+
+
+        //m_cells.Velocity(cell).y += (0 - m_cells.Velocity(cell).y) * 0.25f;
+
+        //Only check downwards
+        if (IsEmpty(x, y - 1)) {
+
+            m_cells.SetFalling(cell, true);
+        }
+
+
+        //Move the cell on x axis depending on its velocity - a little buggy rn
+        else if (std::abs(m_cells.Velocity(cell).x) > 0.1f) {
+
+            //Walls at the edges of the grid are in the ring, they bounce the cell back like any other solid
+            if ((m_cells.Velocity(cell).x < 0 && !IsEmpty(x - 1, y))
+                || (m_cells.Velocity(cell).x > 0 && !IsEmpty(x + 1, y))) {
+                m_cells.Velocity(cell).x *= -1;
+                m_cells.Velocity(cell).x -= m_cells.Velocity(cell).x > 0 ? 0.2f : -0.2f;
+            }
+
+            //Cells up to the ring, an empty ring takes the cell off the grid
+            const int reach = m_cells.Velocity(cell).x > 0 ? width - x : x + 1;
+
+            int lastGood = 0;
+            for (int i = 1; i <= std::ceil(std::abs(m_cells.Velocity(cell).x)) && i <= reach; i++) {
+
+                ///Experimental - if something breaks, remove
+                if (m_cells.Velocity(cell).x > 0 ? IsEmpty(x + i, y - 1) : IsEmpty(x - i, y - 1)) {
+
+                    m_cells.SetFalling(cell, true);
+                    break;
+                }
+
+                else if (m_cells.Velocity(cell).x > 0 ? IsEmpty(x + i, y) : IsEmpty(x - i, y)) {
+                    lastGood = m_cells.Velocity(cell).x < 0 ? -i : i;
+                }
+                else
+                    break;
+
+                m_cells.Velocity(cell).x += (0 - m_cells.Velocity(cell).x) * 0.26f;
+            }
+
+            Swap(x, y, x + lastGood, y);
+        }
+    }
+
+    if (m_cells.IsFalling(cell)) {
+
+        fallingFrom = m_cells.Velocity(cell);
+        float v_y = UpdateVelocity(x, y);
+
+        //Fast enough to skip cells, it flies on outside the grid
+        const velocity_t& v = m_cells.Velocity(cell);
+
+        if (v.x * v.x + v.y * v.y >= PARTICLE_SPEED * PARTICLE_SPEED && IsEmpty(x, y - 1)) {
+
+            Lift(x, y);
+            return;
+        }
+
+        if (std::abs(m_cells.Velocity(cell).x) >= 0.2f) {
+
+            // Calculate the target position based on velocity
+            int targetX = x + static_cast<int>(std::round(m_cells.Velocity(cell).x));
+            int targetY = y - static_cast<int>(std::round(m_cells.Velocity(cell).y));
+
+            // Ensure targetX and targetY are within bounds and reach
+            targetX = std::clamp(targetX, x - maxDisplacement, x + maxDisplacement);
+            targetY = std::clamp(targetY, y - maxDisplacement, y + maxDisplacement);
+            targetX = std::max(0, std::min(targetX, width - 1));
+            targetY = std::max(0, std::min(targetY, height - 1));
+
+            int lastGoodX = x;
+            int lastGoodY = y;
+
+            // Check if the cell can move to the target position
+            if (IsEmpty(targetX, targetY)) {
+                lastGoodX = targetX;
+                lastGoodY = targetY;
+            }
+            else {
+                // Check intermediate positions along the path
+                for (int i = 1; i <= std::max(std::abs(targetX - x), std::abs(targetY - y)); i++) {
+
+                    int intermediateX = x + static_cast<int>(std::round(i * (m_cells.Velocity(cell).x / std::max(std::abs(targetX - x), std::abs(targetY - y)))));
+                    int intermediateY = y - static_cast<int>(std::round(i * (m_cells.Velocity(cell).y / std::max(std::abs(targetX - x), std::abs(targetY - y)))));
+
+                    // Ensure intermediate positions are within bounds
+                    if (!InBounds(intermediateX, intermediateY))
+                        break;
+
+                    if (std::abs(intermediateX - x) > maxDisplacement || std::abs(intermediateY - y) > maxDisplacement)
+                        break;
+
+                    if (IsEmpty(intermediateX, intermediateY)) {
+                        lastGoodX = intermediateX;
+                        lastGoodY = intermediateY;
+                    }
+                    else {
+                        break;
+                    }
+                }
+            }
+
+            // Move the cell to the last good position found
+            if (lastGoodX != x || lastGoodY != y) {
+                Swap(x, y, lastGoodX, lastGoodY);
+            }
+
+            // Gradually lerp velocity.x to 0 while falling
+            m_cells.Velocity(cell).x += (0 - m_cells.Velocity(cell).x) * 0.34f;
+
+            // Set the surrounding cells to falling if necessary - sometimes breaks
+            //SetSurroundingFalling(lastGoodX, lastGoodY, inertialResistance);
+        }
+
+        if (IsEmpty(x, y - 1)) {
+
+            int lastGood = 1;
+
+            //Down to the ring at most
+            for (int i = 1; i <= std::min(m_cells.Velocity(cell).y, (float)maxDisplacement) && i <= y + 1; i++) {
+
+                if (IsEmpty(x, y - i))
+                    lastGood = i;
+                else
+                    break;
+                SetSurroundingFalling(x, y - lastGood, inertialResistance);
+            }
+
+
+            Swap(x, y, x, y - lastGood);
+
+            if (std::abs(fallingFrom.x) < 0.2f && y - lastGood >= 0)
+                fell = lastGood;
+        }
+
+        else if (IsEmpty(x - 1, y - 1) || IsEmpty(x + 1, y - 1)) {
+            int random = RandomBool();
+
+            if (random > 0) {
+                if (IsEmpty(x - 1, y - 1)) {
+
+                    SetSurroundingFalling(x - 1, y - 1, inertialResistance);
+                    Swap(x, y, x - 1, y - 1);
+                    //setSurroundingFalling(x, y, inertialResistance);
+
+                }
+            }
+            else {
+                if (IsEmpty(x + 1, y - 1)) {
+
+                    SetSurroundingFalling(x + 1, y - 1, inertialResistance);
+                    Swap(x, y, x + 1, y - 1);
+                    //setSurroundingFalling(x, y, inertialResistance);
+                }
+            }
+
+            // Gradually lerp velocity.x to 0 while falling
+            //m_cells.Velocity(cell).x += (0.5f - m_cells.Velocity(cell).x) * 0.26f;
+        }
+    }
+
+
+    //At the end of the frame set isFalling to false
+    m_cells.SetFalling(cell, false);
+
+    if (fell > 0)
+        FallColumn(x, y, fell, fallingFrom);
+}
+
+void Sandbox::FallColumn(int x, int y, int distance, const velocity_t& velocity) {
+
+    //Only up to the top of this chunk, the chunk above may be another thread's. The cells have to be the ones this
+    //frame would still update, and nothing may set them apart from a cell falling on its own
+    Chunk* chunk = GetChunkAtCellCoords(x, y);
+    const uint32_t column = 1u << (x - chunk->bottomLeft.x);
+
+    int count = 0;
+
+    for (int above = y + 1; above <= chunk->topRight.y; above++, count++) {
+
+        int cell = Index(x, above);
+
+        if ((chunk->active[above - chunk->bottomLeft.y] & column) == 0 || m_cells.HasMoved(cell) || !m_cells.IsFalling(cell))
+            break;
+        if (GetTraits(m_cells.Type(cell)).kernel != KERNEL_POWDER)
+            break;
+        if (m_cells.Velocity(cell).x != velocity.x || m_cells.Velocity(cell).y != velocity.y)
+            break;
+    }
+
+    if (count == 0) return;
+
+    m_cells.ShiftDown(Index(x, y + 1), count, distance, m_stride);
+    workerSwaps[ThreadPool::WorkerIndex()].count += count;
+
+    //Each cell would have gained the same speed as the one in front of it
+    const velocity_t fallen = m_cells.Velocity(Index(x, y - distance));
+
+    for (int i = y + 1 - distance; i <= y + count; i++) {
+
+        int cell = Index(x, i);
+
+        if (i <= y + count - distance)
+            m_cells.Velocity(cell) = fallen;
+
+        //The cell at y was reported by the swap of the first one
+        if (i != y) {
+
+            m_cells.SetMoved(cell, true);
+            ReportLookChange(cell);
+        }
+    }
+
+    ReportColumnToChunks(x, y + 1 - distance, y + count, true);
+    WakeFollowers(x, y + count);
+}
+
+void Sandbox::MovingGas(int& x, int& y, int) {
+
+
+    const bool leftToRight = RandomBool();
+    const int offset = leftToRight ? 1 : -1;
+
+    if (IsEmpty(x, y + 1)) {
+
+        if(RandomBool())
+            Swap(x, y, x, y + 1);
+    }
+    else if (IsEmpty(x + offset, y)) {
+
+        if (RandomBool())
+            Swap(x, y, x + offset, y);
+    }
+    else if (IsEmpty(x - offset, y)) {
+
+        if (RandomBool())
+            Swap(x, y, x - offset, y);
+    }
+    else if (IsEmpty(x + offset, y + 1)) {
+
+        if (RandomBool())
+            Swap(x, y, x + offset, y + 1);
+    }
+    else if (IsEmpty(x - offset, y + 1)) {
+
+        if (RandomBool())
+            Swap(x, y, x - offset, y + 1);
+    }
+}
+
+void Sandbox::MovingTest(int& x, int& y, int cell, float inertialResistance) {
+
+    // If landing, transfer some of y velocity to x velocity and reduce y velocity
+    if ((!IsEmpty(x, y - 1)) && m_cells.IsFalling(cell)) {
+        m_cells.Velocity(cell).x = RandomBool() ? m_cells.Velocity(cell).y / (4.f / 1 * inertialResistance) : -m_cells.Velocity(cell).y / (4.f / 1 * inertialResistance);
+        m_cells.Velocity(cell).y /= 2.f;
+    }
+
+    if (std::abs(m_cells.Velocity(cell).x) < 0.1f)
+        m_cells.Velocity(cell).x = 0.f;
+
+    if (!m_cells.IsFalling(cell)) {
+        m_cells.Velocity(cell).y = 0;
+
+        if (std::abs(m_cells.Velocity(cell).x) < 0.1f)
+            m_cells.Velocity(cell).x = 0;
+
+        if (IsEmpty(x, y - 1)) {
+            m_cells.SetFalling(cell, true);
+        }
+
+    }
+
+    if (m_cells.IsFalling(cell)) {
+        float v_y = UpdateVelocity(x, y);
+
+        // Calculate the target position based on velocity
+        int targetX = x + static_cast<int>(std::round(m_cells.Velocity(cell).x));
+        int targetY = y - static_cast<int>(std::round(m_cells.Velocity(cell).y));
+
+        // Ensure targetX and targetY are within bounds and reach
+        targetX = std::clamp(targetX, x - maxDisplacement, x + maxDisplacement);
+        targetY = std::clamp(targetY, y - maxDisplacement, y + maxDisplacement);
+        targetX = std::max(0, std::min(targetX, width - 1));
+        targetY = std::max(0, std::min(targetY, height - 1));
+
+        int lastGoodX = x;
+        int lastGoodY = y;
+
+        // Check if the cell can move to the target position
+        if (IsEmpty(targetX, targetY)) {
+            lastGoodX = targetX;
+            lastGoodY = targetY;
+        }
+        else {
+            // Check intermediate positions along the path
+            for (int i = 1; i <= std::max(std::abs(targetX - x), std::abs(targetY - y)); i++) {
+                int intermediateX = x + static_cast<int>(std::round(i * (m_cells.Velocity(cell).x / std::max(std::abs(targetX - x), std::abs(targetY - y)))));
+                int intermediateY = y - static_cast<int>(std::round(i * (m_cells.Velocity(cell).y / std::max(std::abs(targetX - x), std::abs(targetY - y)))));
+
+                // Ensure intermediate positions are within bounds
+                if (!InBounds(intermediateX, intermediateY))
+                    break;
+
+                if (std::abs(intermediateX - x) > maxDisplacement || std::abs(intermediateY - y) > maxDisplacement)
+                    break;
+
+                if (IsEmpty(intermediateX, intermediateY)) {
+                    lastGoodX = intermediateX;
+                    lastGoodY = intermediateY;
+                }
+                else {
+                    break;
+                }
+                m_cells.Velocity(cell).x += (0 - m_cells.Velocity(cell).x) * 0.26f;
+            }
+        }
+
+        // Move the cell to the last good position found
+        if (lastGoodX != x || lastGoodY != y) {
+            Swap(x, y, lastGoodX, lastGoodY);
+        }
+
+        // Gradually lerp velocity.x to 0 while falling
+        m_cells.Velocity(cell).x += (0 - m_cells.Velocity(cell).x) * 0.26f;
+
+        // Set the surrounding cells to falling if necessary
+        SetSurroundingFalling(lastGoodX, lastGoodY, inertialResistance);
+    }
+
+    // At the end of the frame set isFalling to false if there's no empty space below
+        m_cells.SetFalling(cell, false);
+}
+
+template<>
+void Sandbox::UpdateKernel<KERNEL_NONE>(int&, int&, const ElementTraits&) {
+}
+
+template<>
+void Sandbox::UpdateKernel<KERNEL_POWDER>(int& x, int& y, const ElementTraits& traits) {
+
+    MovingSolid(x, y, Index(x, y), traits.inertialResistance);
+    KeepAwakeIfUnsettled(x, y, false);
+}
+
+template<>
+void Sandbox::UpdateKernel<KERNEL_LIQUID>(int& x, int& y, const ElementTraits& traits) {
+
+    const bool leftToRight = RandomBool();
+    const int offset = leftToRight ? 1 : -1;
+
+    if (IsEmpty(x, y - 1)) {
+
+        Swap(x, y, x, y - 1);
+    }
+    else if (IsEmpty(x + offset, y)) {
+        Swap(x, y, x + offset, y);
+    }
+
+    if (traits.fireChance > 0.f) {
+
+        if (IsEmpty(x, y + 1) && RandomFloat(0.f, 1.f) < traits.fireChance) {
+            Replace(x, y + 1, FIRE);
+        }
+
+        //Keeps spawning fire even when it does not move
+        ReportToChunk(x, y);
+    }
+    else
+        KeepAwakeIfUnsettled(x, y, true);
+}
+
+template<>
+void Sandbox::UpdateKernel<KERNEL_FUEL>(int& x, int& y, const ElementTraits& traits) {
+
+    int cell = Index(x, y);
+
+    //Spread by SpreadHeat before the update, fuel already on fire does not take any more
+    if (!m_cells.IsBurning(cell))
+        m_cells.Temperature(cell) += m_heat.Gain(cell);
+
+    if (!m_cells.IsBurning(cell) && m_cells.Temperature(cell) >= traits.ignitionTemperature) {
+
+        //Hot enough, it tries again next frame when it does not catch fire now
+        if (RandomFloat(0.f, 1.f) < 0.3f)
+            Ignite(x, y);
+        else
+            ReportToChunk(x, y);
+    }
+
+    Burn(x, y);
+
+    if (m_cells.Life(cell) <= 0)
+        Replace(x, y, EMPTY);
+}
+
+template<>
+void Sandbox::UpdateKernel<KERNEL_GAS>(int& x, int& y, const ElementTraits& traits) {
+
+    int cell = Index(x, y);
+
+    SettleHot(cell);
+
+    if (m_cells.Life(cell) <= 0) {
+
+        if (traits.smokeChance > 0.f && RandomFloat(0.f, 1.f) < traits.smokeChance)
+            Replace(x, y, SMOKE);
+        else
+            Replace(x, y, EMPTY);
+
+        return;
+    }
+
+    m_cells.Life(cell) -= traits.lifeDecay;
+
+    ReportToChunk(x, y);
+
+    MovingGas(x, y, cell);
+}
+
+template<size_t... I>
+constexpr std::array<Sandbox::UpdateKernelFn, NR_ELEMENTS> Sandbox::MakeKernelTable(std::index_sequence<I...>) {
+
+    return { &Sandbox::UpdateKernel<ELEMENT_TRAITS[I].kernel>... };
+}
+
+const std::array<Sandbox::UpdateKernelFn, NR_ELEMENTS> Sandbox::s_updateKernels = Sandbox::MakeKernelTable(std::make_index_sequence<NR_ELEMENTS>());
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "Cells.h"
+#include "SimulationBackend.h"
+#include "ElementTraits.h"
+#include "CellGrid.h"
+#include "HeatField.h"
+#include "ParticleSystem.h"
+#include <vector>
+#include "Chunk.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <functional>
+#include <array>
+#include <utility>
+
+#define TILE_SIZE 4
+#define SCREEN_WIDTH 1280
+#define SCREEN_HEIGHT 720
+
+//Fuel next to cells hotter than HEAT_SOURCE_TEMPERATURE takes in HEAT_ABSORB_RATE of their temperature per second.
+//Heat is spread from the temperatures the frame starts with, so fire reaches further only a frame later. The rate is
+//a bit above the 15% chance of taking 25 times the temperature it replaced, to burn as fast as that did
+#define HEAT_SOURCE_TEMPERATURE 100.f
+#define HEAT_ABSORB_RATE 4.25f
+
+//Frames a cell that has room to move but does not is looked at again before it falls asleep. A sleeping cell is
+//only updated again once a neighbour moves, is removed or is placed next to it
+#define SLEEP_FRAMES 12
+
+//Powder moving at least PARTICLE_SPEED cells per frame through the air leaves the grid and flies on as a particle
+//until it hits something. Particles lose PARTICLE_DRAG of their sideways speed every frame and fall at most
+//PARTICLE_MAX_FALL cells per frame, like falling cells in the grid
+#define PARTICLE_SPEED 4.f
+#define PARTICLE_DRAG 0.34f
+#define PARTICLE_MAX_FALL 50.f
+
+//What lies beyond the edges of the grid. BOUNDARY_WALL is border cells nothing passes, BOUNDARY_WRAP the opposite
+//edge, cells leaving on one side come in on the other, BOUNDARY_SINK empty cells that take in whatever leaves the grid
+enum BoundaryMode { BOUNDARY_WALL, BOUNDARY_WRAP, BOUNDARY_SINK };
+
+class Sandbox : public SimulationBackend {
+
+private:
+	//The grid with a ring of one cell around it holding the boundary, so the rules read the neighbours of any cell
+	//without bounds checks. Cell x, y is at Index(x, y), the looks handed to the renderer start at cell 0, 0
+	CellGrid m_cells;
+	int m_stride = 0;
+	BoundaryMode m_boundary = BOUNDARY_WALL;
+
+	HeatField m_heat;
+	Chunk* chunks = nullptr;
+	ThreadPool* threadPool = nullptr;
+	int threadCount = 0;
+
+	//Look changes recorded by pool workers 1..n-1, merged into changedCells after the update
+	std::vector<std::vector<int>> workerChangedCells;
+
+	//Cells flying outside the grid
+	ParticleSystem m_particles;
+
+	//A cell lifted out of the grid this frame, at Index(x, y)
+	struct LiftedCell { int index; int x, y; cell_t cell; };
+	//Cells each pool worker lifted this frame, they join m_particles in the order of their cells
+	std::vector<std::vector<LiftedCell>> workerLifted;
+
+	//Swaps done by each pool worker this frame, a cache line apart so the workers do not fight over them
+	struct alignas(64) SwapCounter { long long count = 0; };
+	std::vector<SwapCounter> workerSwaps;
+
+	//Column of chunks each pool worker is updating, -1 outside the chunk update
+	std::vector<int> workerColumns;
+
+	//How far a cell may travel in one update. Bounded in the parallel mode so chunks of one phase never touch the same cells
+	int maxDisplacement;
+
+	//Frames simulated so far, keys the counter-based random numbers
+	unsigned long long frameCount = 0;
+
+	//One kernel per element, picked at compile time from ELEMENT_TRAITS
+	typedef void (Sandbox::*UpdateKernelFn)(int&, int&, const ElementTraits&);
+	static const std::array<UpdateKernelFn, NR_ELEMENTS> s_updateKernels;
+
+	template<size_t... I>
+	static constexpr std::array<UpdateKernelFn, NR_ELEMENTS> MakeKernelTable(std::index_sequence<I...>);
+
+public:
+
+	float gravity = 9.81f;
+	double dt = 0.0;
+
+	//Active cells visited by the last Update()
+	int lastUpdatedCells = 0;
+	//Swap calls made by the last Update(), a column falling in one go counts one per cell
+	long long lastSwapCount = 0;
+
+public:
+
+	Sandbox();
+	Sandbox(int width, int height);
+	~Sandbox() override;
+
+	int numCellsPerChunk;
+	int chunkSize;
+
+	int chunk_width;
+	int chunk_height;
+
+	void ReportLookChange(int index);
+
+	void CheckCell(int cell, int& x, int& y);
+	void Update() override;
+	void UpdateCellsInChunk(Chunk* chunk);
+	void UpdateChunks();
+	void UpdateDeltaTime(double dt) override;
+
+	//The chunks are always updated in two phases of every other column, on n threads when n > 1 and on the calling thread
+	//otherwise
+	void SetThreadCount(int threadCount);
+	int GetThreadCount() const;
+
+	void SetBoundary(BoundaryMode boundary);
+	BoundaryMode GetBoundary() const;
+
+	inline int GetParticleCount() const { return m_particles.Count(); }
+
+	ElementCensus TakeCensus() override;
+
+protected:
+
+	void PaintSpans(const CellSpan* spans, int count) override;
+	void FillSpans(const CellSpan* spans, int count, Element type) override;
+
+private:
+
+	void CreateCells(int& width, int& height);
+
+	inline int Index(int x, int y) const { return m_stride * (y + 1) + x + 1; }
+	//Sets the ring to the boundary. Walls and sinks are only written here, a wrapping ring copies the opposite edges
+	//and is refreshed every frame
+	void FillBoundary();
+
+	//A new cell of the type, stamped with the current time when it is animated
+	cell_t Spawn(Element type);
+	//Marks a hot cell LOOK_SPENT once the shader has faded it out, before its stamp wraps around
+	void SettleHot(int index);
+
+	//Fills m_heat around the active cells of this frame, before any of them is updated
+	void SpreadHeat();
+
+	//Takes the cell out of the grid, it flies on as a particle from the end of the frame
+	void Lift(int x, int y);
+	//Moves the particles and puts those that hit something back into the grid, after the cells were updated
+	void MoveParticles();
+	//Walks particle i along its path this frame, false once it is back in the grid or left it through a sink
+	bool FlyParticle(int i);
+	//Nearest empty cell to x, y in rings of growing range, the higher rows of a ring first. Across the edges when they
+	//wrap. False only when the grid has no empty cell
+	bool FindLanding(int& x, int& y) const;
+	//Region writes overwrite particles flying inside the spans
+	void RemoveParticles(const CellSpan* spans, int count);
+
+	void Ignite(int& x, int& y);
+	void Burn(int& x, int& y);
+
+	void CreateChunks();
+	Chunk* GetChunkAtCellCoords(int x, int y);
+	void ReportToChunk(int x, int y);
+	//Cells y1..y2 of column x were touched, reported with the same margin in one go.
+	//Without wakes the cells are only kept awake, see Chunk::keepNextCells
+	void ReportColumnToChunks(int x, int y1, int y2, bool wakes);
+	//Cells minX..maxX, minY..maxY were touched, clipped to the grid and split between the chunks at once
+	void ReportRectToChunks(int minX, int minY, int maxX, int maxY, bool wakes);
+	void KeepAwakeIfUnsettled(int x, int y, bool spreadsSideways);
+	//Cell x, y was left, the cells next to and above it may follow it still this frame. Only in the column of chunks
+	//the worker is updating, the others are reported for the next frame anyway
+	void WakeFollowers(int x, int y);
+	void EndChunkFrame();
+
+	void Replace(int x, int y, Element type);
+	//x1, y1 has to be in the grid, x2, y2 may be in the ring
+	void Swap(int x1, int y1, int x2, int y2);
+	//Moves the cell over the edge to the boundary's other side, or drops it into the sink
+	void SwapOut(int x1, int y1, int x2, int y2);
+	//In the grid or the ring around it
+	inline bool IsEmpty(int x, int y) const { return m_cells.Type(Index(x, y)) == EMPTY; }
+	bool InBounds(int x, int y) const;
+
+	void SetSurroundingFalling(int x, int y, float& inertialResistance);
+	float UpdateVelocity(int x, int y);
+	void MovingSolid(int& x, int& y, int cell, float inertialResistance);
+	//The cell at x, y just fell distance cells straight down. Powder right above it falling with the same velocity it
+	//had would follow it just as far, so the run moves down with it at once
+	void FallColumn(int x, int y, int distance, const velocity_t& velocity);
+	void MovingGas(int& x, int& y, int cell);
+	void MovingTest(int& x, int& y, int cell, float inertialResistance);
+
+	template<ElementKernel K>
+	void UpdateKernel(int& x, int& y, const ElementTraits& traits);
+};
\ No newline at end of file
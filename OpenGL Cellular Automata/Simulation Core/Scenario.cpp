@@ -0,0 +1,101 @@
+#include "Scenario.h"
+#include <utility>
+
+static std::vector<Scenario> CreateScenarios() {
+
+    std::vector<Scenario> scenarios;
+
+    scenarios.push_back({ "sand", "Sand avalanche - a block of sand collapsing onto the floor",
+        [](SimulationBackend& s) {
+            s.FillRect(s.width / 4, s.height / 2, s.width * 3 / 4, s.height - 2, SAND);
+        },
+        nullptr });
+
+    scenarios.push_back({ "water", "Water fill - a column of water poured into a stone basin",
+        [](SimulationBackend& s) {
+            s.FillRect(0, 0, s.width - 1, 2, STONE);
+            s.FillRect(0, 0, 2, s.height / 2, STONE);
+            s.FillRect(s.width - 3, 0, s.width - 1, s.height / 2, STONE);
+            s.FillRect(s.width / 3, s.height / 3, s.width * 2 / 3, s.height - 2, WATER);
+        },
+        [](SimulationBackend& s, int) {
+            Element previousType = s.currentType;
+            s.currentType = WATER;
+            s.DrawCircle(s.width / 2, s.height - 4, 3);
+            s.currentType = previousType;
+        } });
+
+    scenarios.push_back({ "fire", "Forest fire - a band of wood ignited from below",
+        [](SimulationBackend& s) {
+            s.FillRect(0, 0, s.width - 1, 2, STONE);
+            s.FillRect(0, 3, s.width - 1, s.height / 3, WOOD);
+            s.FillRect(s.width / 2 - 4, s.height / 3 + 1, s.width / 2 + 4, s.height / 3 + 3, LAVA);
+        },
+        nullptr });
+
+    scenarios.push_back({ "idle", "Mostly idle world - settled stone with a trickle of sand",
+        [](SimulationBackend& s) {
+            s.FillRect(0, 0, s.width - 1, s.height / 2, STONE);
+        },
+        [](SimulationBackend& s, int frame) {
+            if (frame % 10 == 0) {
+                Element previousType = s.currentType;
+                s.currentType = SAND;
+                s.DrawCircle(s.width / 2, s.height - 2, 1);
+                s.currentType = previousType;
+            }
+        } });
+
+    scenarios.push_back({ "embers", "Settled world with a few fires - lava pools burning in pockets of stone",
+        [](SimulationBackend& s) {
+            s.FillRect(0, 0, s.width - 1, s.height - 1, STONE);
+
+            for (int i = 1; i <= 4; i++) {
+
+                int x = s.width * i / 5;
+                s.ClearRect(x - 3, s.height / 3, x + 3, s.height / 3 + 8);
+                s.FillRect(x - 3, s.height / 3, x + 3, s.height / 3 + 1, LAVA);
+            }
+        },
+        nullptr });
+
+    //One full-screen FillScreen per element that has a cell factory
+    const std::pair<const char*, Element> fills[] = {
+        { "sand", SAND }, { "water", WATER }, { "wood", WOOD }, { "stone", STONE },
+        { "lava", LAVA }, { "fire", FIRE }, { "smoke", SMOKE }
+    };
+
+    for (const auto& fill : fills) {
+
+        Element type = fill.second;
+
+        scenarios.push_back({ std::string("fill-") + fill.first, std::string("Whole screen filled with ") + fill.first,
+            [type](SimulationBackend& s) {
+                Element previousType = s.currentType;
+                s.currentType = type;
+                s.FillScreen();
+                s.currentType = previousType;
+            },
+            nullptr });
+    }
+
+    return scenarios;
+}
+
+const std::vector<Scenario>& GetScenarios() {
+
+    static std::vector<Scenario> scenarios = CreateScenarios();
+
+    return scenarios;
+}
+
+const Scenario* FindScenario(const std::string& name) {
+
+    for (const Scenario& scenario : GetScenarios()) {
+
+        if (scenario.name == name)
+            return &scenario;
+    }
+
+    return NULL;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "SimulationBackend.h"
+#include <string>
+#include <vector>
+#include <functional>
+
+//A reproducible starting state for running the simulation without a window
+typedef struct Scenario {
+
+	std::string name;
+	std::string description;
+
+	//Called once on a freshly constructed backend
+	std::function<void(SimulationBackend&)> setup;
+
+	//Called before every simulated frame, may be empty
+	std::function<void(SimulationBackend&, int)> step;
+
+}Scenario;
+
+const std::vector<Scenario>& GetScenarios();
+const Scenario* FindScenario(const std::string& name);
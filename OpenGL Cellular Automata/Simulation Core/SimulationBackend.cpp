@@ -0,0 +1,139 @@
+#include "SimulationBackend.h"
+#include <algorithm>
+#include <cmath>
+
+void iterateAndApplyMethodBetweenTwoPoints(vector_t pos1, vector_t pos2, const std::function<void(int, int)>& method) {
+    // If the two points are the same no need to iterate
+    if (pos1.x == pos2.x && pos1.y == pos2.y) {
+
+        return;
+    }
+
+    int matrixX1 = pos1.x;
+    int matrixY1 = pos1.y;
+    int matrixX2 = pos2.x;
+    int matrixY2 = pos2.y;
+
+    int xDiff = matrixX1 - matrixX2;
+    int yDiff = matrixY1 - matrixY2;
+    bool xDiffIsLarger = std::abs(xDiff) > std::abs(yDiff);
+
+    int xModifier = xDiff < 0 ? 1 : -1;
+    int yModifier = yDiff < 0 ? 1 : -1;
+
+    int longerSideLength = std::max(std::abs(xDiff), std::abs(yDiff));
+    int shorterSideLength = std::min(std::abs(xDiff), std::abs(yDiff));
+    float slope = (shorterSideLength == 0 || longerSideLength == 0) ? 0 : ((float)(shorterSideLength) / (longerSideLength));
+
+    int shorterSideIncrease;
+    for (int i = 1; i <= longerSideLength; i++) {
+        shorterSideIncrease = std::round(i * slope);
+        int yIncrease, xIncrease;
+        if (xDiffIsLarger) {
+            xIncrease = i;
+            yIncrease = shorterSideIncrease;
+        }
+        else {
+            yIncrease = i;
+            xIncrease = shorterSideIncrease;
+        }
+        int currentY = matrixY1 + (yIncrease * yModifier);
+        int currentX = matrixX1 + (xIncrease * xModifier);
+        method(currentX, currentY);
+    }
+}
+
+void SimulationBackend::DrawCircle(int x, int y, int radius) {
+
+    DrawStroke(x, y, x, y, radius);
+}
+
+void SimulationBackend::DrawStroke(int x1, int y1, int x2, int y2, int radius) {
+
+    std::vector<CellSpan> spans;
+    SweepCircle(x1, y1, x2, y2, radius, spans);
+
+    if (!spans.empty())
+        PaintSpans(spans.data(), (int)spans.size());
+}
+
+void SimulationBackend::FillRect(int x1, int y1, int x2, int y2, Element type) {
+
+    x1 = std::max(x1, 0);
+    y1 = std::max(y1, 0);
+    x2 = std::min(x2, width - 1);
+    y2 = std::min(y2, height - 1);
+
+    if (x1 > x2 || y1 > y2)
+        return;
+
+    std::vector<CellSpan> spans;
+    spans.reserve(y2 - y1 + 1);
+
+    for (int y = y1; y <= y2; y++)
+        spans.push_back({ y, x1, x2 });
+
+    FillSpans(spans.data(), (int)spans.size(), type);
+}
+
+void SimulationBackend::FillCircle(int x, int y, int radius, Element type) {
+
+    std::vector<CellSpan> spans;
+    SweepCircle(x, y, x, y, radius, spans);
+
+    if (!spans.empty())
+        FillSpans(spans.data(), (int)spans.size(), type);
+}
+
+void SimulationBackend::SweepCircle(int x1, int y1, int x2, int y2, int radius, std::vector<CellSpan>& spans) const {
+
+    if (radius <= 0)
+        return;
+
+    //Cells closer than the radius like the brush always drew, so halfWidths[dy] * halfWidths[dy] + dy * dy < radius * radius
+    std::vector<int> halfWidths(radius);
+
+    for (int dy = 0; dy < radius; dy++) {
+
+        int halfWidth = (int)std::sqrt((double)(radius * radius - dy * dy - 1));
+
+        while (halfWidth * halfWidth + dy * dy >= radius * radius)
+            halfWidth--;
+        while ((halfWidth + 1) * (halfWidth + 1) + dy * dy < radius * radius)
+            halfWidth++;
+
+        halfWidths[dy] = halfWidth;
+    }
+
+    //Every row of the swept area is a single run, the circles along the line are at most a cell apart
+    int bottom = std::min(y1, y2) - radius + 1;
+    int rows = std::abs(y2 - y1) + 2 * radius - 1;
+
+    std::vector<int> left(rows, INT_MAX);
+    std::vector<int> right(rows, INT_MIN);
+
+    auto stamp = [&](int x, int y) {
+
+        for (int dy = -radius + 1; dy < radius; dy++) {
+
+            int row = y + dy - bottom;
+            int halfWidth = halfWidths[std::abs(dy)];
+
+            left[row] = std::min(left[row], x - halfWidth);
+            right[row] = std::max(right[row], x + halfWidth);
+        }
+    };
+
+    stamp(x1, y1);
+    iterateAndApplyMethodBetweenTwoPoints({ x1, y1 }, { x2, y2 }, stamp);
+
+    for (int row = 0; row < rows; row++) {
+
+        int y = bottom + row;
+        int spanLeft = std::max(left[row], 0);
+        int spanRight = std::min(right[row], width - 1);
+
+        if (y >= 0 && y < height && spanLeft <= spanRight)
+            spans.push_back({ y, spanLeft, spanRight });
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Cells.h"
+#include <vector>
+#include <climits>
+#include <functional>
+
+//Number of cells and summed row of every element. Backends do not move cells identically, so they are compared on these
+typedef struct ElementCensus {
+
+	long long count[NR_ELEMENTS];
+	double heightSum[NR_ELEMENTS];
+
+}ElementCensus;
+
+//Cells x1 to x2 of row y, inclusive
+typedef struct CellSpan {
+
+	int y;
+	int x1, x2;
+
+}CellSpan;
+
+//A cell the backend moves outside its grid, drawn over the looks at a position in cells
+typedef struct FlyingCell {
+
+	float x, y;
+	look_t look;
+
+}FlyingCell;
+
+//Calls method(x, y) for every cell on the line from pos1 to pos2, pos1 itself excluded. Consecutive cells are
+//at most one step apart on either axis
+void iterateAndApplyMethodBetweenTwoPoints(vector_t pos1, vector_t pos2, const std::function<void(int, int)>& method);
+
+//What the window, the scenarios and the tools drive. Sandbox runs on the CPU, GpuSandbox in compute shaders
+class SimulationBackend {
+
+public:
+
+	int width = 0;
+	int height = 0;
+
+	Element currentType = STONE;
+
+	//Simulated seconds, hot looks are stamped with it and the renderer ages them by it
+	double time = 0.0;
+
+	//Look of every cell for the renderer to upload, nullptr when the backend writes the looks on the GPU. Row y starts
+	//at looks + lookStride * y, the backend may keep cells of its own between the rows
+	const look_t* looks = nullptr;
+	int lookStride = 0;
+	//Indices of cells whose look changed since the renderer last uploaded them, lookStride * y + x
+	std::vector<int> changedCells;
+	//Rows region writes replaced since then, uploaded whole on top of changedCells. None while changedRowMin > changedRowMax
+	int changedRowMin = INT_MAX;
+	int changedRowMax = -1;
+	//Cells in flight after the last Update(), replaced every frame and not part of the looks
+	std::vector<FlyingCell> flyingCells;
+
+public:
+
+	virtual ~SimulationBackend() {}
+
+	virtual void Update() = 0;
+	virtual void UpdateDeltaTime(double dt) = 0;
+
+	//The brush, places cells only into empty ones except for the eraser, and leaves gaps in gases
+	void DrawCircle(int x, int y, int radius);
+	//The brush swept from one position to the next, so fast strokes leave no gaps
+	void DrawStroke(int x1, int y1, int x2, int y2, int radius);
+
+	//Region writes for map resets and scripted setups. Unlike the brush they overwrite every cell inside, with no gaps
+	//in gases. Coordinates are inclusive and clipped to the grid
+	void FillRect(int x1, int y1, int x2, int y2, Element type);
+	void FillCircle(int x, int y, int radius, Element type);
+	inline void ClearRect(int x1, int y1, int x2, int y2) { FillRect(x1, y1, x2, y2, EMPTY); }
+	inline void FillScreen() { FillRect(0, 0, width - 1, height - 1, currentType); }
+
+	virtual ElementCensus TakeCensus() = 0;
+
+	//Looks from the first cell to the last one, with whatever lies between the rows
+	inline int LookCount() const { return lookStride * (height - 1) + width; }
+
+	inline void ReportRowsChanged(int first, int last) {
+
+		changedRowMin = first < changedRowMin ? first : changedRowMin;
+		changedRowMax = last > changedRowMax ? last : changedRowMax;
+	}
+
+	//After the looks were uploaded, or by tools that do not upload them
+	inline void ClearLookChanges() {
+
+		changedCells.clear();
+		changedRowMin = INT_MAX;
+		changedRowMax = -1;
+	}
+
+protected:
+
+	//Applies the brush to the spans all at once, they are clipped and ordered by row
+	virtual void PaintSpans(const CellSpan* spans, int count) = 0;
+	//Overwrites the spans with new cells of the type all at once, the spans are clipped and ordered by row
+	virtual void FillSpans(const CellSpan* spans, int count, Element type) = 0;
+
+private:
+
+	//Rows of the cells closer than radius to the segment, the area a circle covers when moved along it
+	void SweepCircle(int x1, int y1, int x2, int y2, int radius, std::vector<CellSpan>& spans) const;
+};
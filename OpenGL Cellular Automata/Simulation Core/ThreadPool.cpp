@@ -0,0 +1,138 @@
+#include "ThreadPool.h"
+
+static thread_local int t_workerIndex = 0;
+
+ThreadPool::ThreadPool(int threadCount)
+    : m_task(nullptr), m_remaining(0), m_generation(0), m_stop(false)
+{
+    if (threadCount < 1)
+        threadCount = 1;
+
+    for (int i = 0; i < threadCount; i++)
+        m_queues.push_back(std::make_unique<WorkQueue>());
+
+    for (int i = 1; i < threadCount; i++)
+        m_threads.emplace_back(&ThreadPool::WorkerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+
+    m_wake.notify_all();
+
+    for (std::thread& thread : m_threads)
+        thread.join();
+}
+
+int ThreadPool::WorkerIndex() {
+
+    return t_workerIndex;
+}
+
+void ThreadPool::ParallelFor(int count, const std::function<void(int)>& task) {
+
+    if (count <= 0)
+        return;
+
+    //The task and counter have to be visible before the first item can be popped
+    m_task = &task;
+    m_remaining = count;
+
+    int numQueues = (int)m_queues.size();
+
+    for (int i = 0; i < count; i++) {
+
+        WorkQueue& queue = *m_queues[i % numQueues];
+
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.items.push_back(i);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_generation++;
+    }
+
+    m_wake.notify_all();
+
+    RunTasks(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_remaining.load() == 0; });
+}
+
+void ThreadPool::WorkerLoop(int index) {
+
+    t_workerIndex = index;
+
+    unsigned long long seen = 0;
+
+    while (true) {
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+
+            if (m_stop)
+                return;
+
+            seen = m_generation;
+        }
+
+        RunTasks(index);
+    }
+}
+
+void ThreadPool::RunTasks(int index) {
+
+    int item;
+
+    while (TryPop(index, item)) {
+
+        (*m_task)(item);
+
+        if (--m_remaining == 0) {
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_done.notify_all();
+        }
+    }
+}
+
+bool ThreadPool::TryPop(int index, int& item) {
+
+    //Own queue first, oldest item first
+    {
+        WorkQueue& queue = *m_queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (!queue.items.empty()) {
+
+            item = queue.items.front();
+            queue.items.pop_front();
+            return true;
+        }
+    }
+
+    //Steal from the back of the others
+    int numQueues = (int)m_queues.size();
+
+    for (int i = 1; i < numQueues; i++) {
+
+        WorkQueue& queue = *m_queues[(index + i) % numQueues];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (!queue.items.empty()) {
+
+            item = queue.items.back();
+            queue.items.pop_back();
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+//Fixed set of worker threads with one work queue each. Idle workers steal from the back of the other queues.
+class ThreadPool {
+
+private:
+
+	struct WorkQueue {
+
+		std::mutex mutex;
+		std::deque<int> items;
+	};
+
+	std::vector<std::thread> m_threads;
+	std::vector<std::unique_ptr<WorkQueue>> m_queues;
+
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_done;
+
+	const std::function<void(int)>* m_task;
+	std::atomic<int> m_remaining;
+	unsigned long long m_generation;
+	bool m_stop;
+
+public:
+
+	//threadCount includes the calling thread, which takes part in every ParallelFor
+	ThreadPool(int threadCount);
+	~ThreadPool();
+
+	int GetThreadCount() const { return (int)m_queues.size(); }
+
+	//Runs task(i) for every i in [0, count) and returns once all of them finished
+	void ParallelFor(int count, const std::function<void(int)>& task);
+
+	//0 on the thread that owns the pool, 1..n-1 on the workers
+	static int WorkerIndex();
+
+private:
+
+	void WorkerLoop(int index);
+	void RunTasks(int index);
+	bool TryPop(int index, int& item);
+};